@@ -0,0 +1,73 @@
+/*
+The same as the I2CBus example, but using an AsyncI2CBus, so loop() doesn't wait for the I2C transfers.
+endFrame() starts writing the outputs, and reading the inputs for the next frame, and then returns straight away.
+The transfers complete in the background (in the TWI interrupt) while loop() does its other work.
+
+Each second, the time spent in beginFrame() and endFrame() during the last loop is printed to the serial console,
+which is much less than the time taken by the I2C transfers themselves.
+
+Wiring is the same as the I2CBus example.
+
+Note, do not include Wire.h (AsyncI2CBus replaces it).
+*/
+
+#include <abstractIO.h>
+#include <abstractAsyncI2C.cpp.h>
+
+AsyncI2CBus asyncBus( 400000 );
+
+BufferedMCP23017* expanderA = new BufferedMCP23017( 0, &asyncBus );
+BufferedMCP23017* expanderB = new BufferedMCP23017( 1, &asyncBus );
+
+// Created in setup(), because the I2C bus doesn't work until then.
+Input* buttonA;
+Input* buttonB;
+Output* ledA;
+Output* ledB;
+
+unsigned long frameMicros;
+
+void report()
+{
+    Serial.print( "Microseconds in beginFrame and endFrame : " );
+    Serial.print( frameMicros );
+    Serial.print( " Transactions per frame : " );
+    Serial.print( asyncBus.frameTransactions );
+    Serial.print( " Errors : " );
+    Serial.println( asyncBus.errors );
+}
+
+RunPeriodically reporter( 1000, report );
+
+void setup()
+{
+    Serial.begin( 9600 );
+
+    expanderA->beginConfiguration();
+    expanderB->beginConfiguration();
+    buttonA = expanderA->createInput( 0, LOW, true );
+    buttonB = expanderB->createInput( 0, LOW, true );
+    ledA = expanderA->createOutput( 8 );
+    ledB = expanderB->createOutput( 8 );
+    expanderA->endConfiguration();
+    expanderB->endConfiguration();
+
+    asyncBus.prefetch = true;
+}
+
+void loop()
+{
+    unsigned long start = micros();
+    asyncBus.beginFrame(); // Waits for the inputs which were read in the background (usually finished already).
+    unsigned long middle = micros();
+
+    // Each button lights the LED on the other chip.
+    ledA->set( buttonB->get() );
+    ledB->set( buttonA->get() );
+
+    unsigned long end = micros();
+    asyncBus.endFrame(); // Starts writing the outputs and reading the inputs, but doesn't wait.
+    frameMicros = (middle - start) + (micros() - end);
+
+    reporter.run(); // Printing is slow, so this is where the I2C transfers happen.
+}
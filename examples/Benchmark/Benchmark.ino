@@ -0,0 +1,301 @@
+/*
+Measures the time per call of the library's classes, and prints the results to the serial console as CSV,
+so that the results of different releases (or boards) can be compared.
+
+The output is a few lines of comments (starting with #), then a header line, then one line per benchmark :
+
+    name,calls,micros,nanosPerCall
+    SimpleInput get,1000,4508,4508
+
+'micros' is the total time for all calls, less the time taken by the same number of calls to an empty function.
+
+Nothing needs to be connected; the pins are shared between the benchmarks, as only the time is measured.
+The exception is the MCP23017, as Wire can hang without the I2C pullup resistors. To include the MCP23017
+benchmarks, connect an MCP23017 at address 0 (see the MCP23017 example), and uncomment BENCHMARK_MCP23017 below.
+
+This sketch can also be run on a PC, using the simulated hardware in the "host" directory (make benchmark).
+'micros' and 'nanosPerCall' are then the simulated cost of the I/O only (the cost of the library's own code
+isn't simulated, so pure calculations, such as the eases, show 0). Each line has extra columns, counting the
+hardware operations used by all of the calls, and 'hostNanosPerCall', the REAL time per call on the PC,
+which shows the relative cost of the library's own code (but is nothing like the time it takes on an Arduino).
+*/
+
+//#define BENCHMARK_MCP23017
+
+#include <Wire.h>
+#include <SPI.h>
+#include <abstractIO.h>
+#include <abstractShiftRegister.h>
+#include <abstractFixed.h>
+#include <abstractMCP23017.cpp.h>
+#include <abstractSPIShiftRegister.cpp.h>
+
+const int defaultCalls = 1000;
+
+// Results are written to these, so that the compiler can't optimise the calls away.
+volatile boolean booleanSink;
+volatile float floatSink;
+volatile q15 fixedSink;
+volatile byte byteSink;
+
+// Inputs to the eases and PWM outputs. Volatile, so that the compiler can't calculate the results in advance.
+volatile float floatSource = 0.3;
+volatile q15 fixedSource = FLOAT_TO_Q15( 0.3 );
+volatile byte byteSource = 77;
+
+boolean toggle;
+byte address;
+byte shiftBuffer[2];
+MuxBits muxBits;
+float analogValues[8];
+
+// Digital inputs and outputs
+Input* simpleInput = new SimpleInput( 2 );
+Input* debouncedInput = simpleInput->debounced();
+InputButton* inputButton = simpleInput->button();
+Output* simpleOutput = new SimpleOutput( 4 );
+
+// Analog inputs
+AnalogInput* simpleAnalogInput = new SimpleAnalogInput( A0 );
+AnalogInput* clippedAnalogInput = simpleAnalogInput->clip( 0.1, 0.9 );
+AnalogInput* scaledAnalogInput = simpleAnalogInput->scale( 0.5 );
+AnalogInput* easedAnalogInput = simpleAnalogInput->ease( &easeInQuad );
+AnalogInput* fusedAnalogInput = simpleAnalogInput->fused( 0.1, 0.9, 0.5, &easeInQuad );
+FixedAnalogInput* fixedAnalogInput = new SimpleFixedAnalogInput( A0 );
+FixedAnalogInput* clippedFixedAnalogInput = fixedAnalogInput->clip( FLOAT_TO_Q15( 0.1 ), FLOAT_TO_Q15( 0.9 ) );
+
+// PWM outputs
+PWMOutput* simplePWMOutput = new SimplePWMOutput( 3 );
+PWMOutput* scaledPWMOutput = simplePWMOutput->scale( 0.5 );
+PWMOutput* easedPWMOutput = simplePWMOutput->ease( &easeInQuad );
+FixedPWMOutput* fixedPWMOutput = new SimpleFixedPWMOutput( 3 );
+FixedPWMOutput* easedFixedPWMOutput = fixedPWMOutput->ease( &fixedEaseInQuad );
+
+// Eases
+TabulatedEase* tabulatedEase = new TabulatedEase( &easeInQuart, 64 );
+
+// Shift registers (bit-banged using data A2, clock A3 and latch 9, and using SPI with latch 10).
+ShiftRegister* shiftRegister = new LatchedShiftRegister( A2, A3, 9 );
+ShiftRegister* spiShiftRegister = new LatchedSPIShiftRegister( 10 );
+BufferedShiftRegister* bufferedShiftRegister = shiftRegister->buffer( 2 );
+BufferedShiftRegister* spiBufferedShiftRegister = spiShiftRegister->buffer( 2 );
+
+// Multiplexers, using each kind of Selector. Digital inputs use pin 8, and analog inputs use A1.
+Mux* addressMux = (new AddressSelector( 5, 6, 7 ))->createMux( 8 );
+Mux* booleanMux = (new BooleanSelector( 9 ))->createMux( 8 );
+Mux* shiftRegisterMux = (new ShiftRegisterSelector( shiftRegister, 16 ))->createMux( 8 );
+Mux* wholeBytesMux = (new ShiftRegisterSelector( shiftRegister, 16, LOW, true ))->createMux( 8 );
+Mux* comboMux = (new ComboSelector( shiftRegister ))->createMux( 8 );
+AnalogMux* analogMux = (new AddressSelector( 5, 6, 7 ))->createAnalogMux( A1 );
+
+#ifdef BENCHMARK_MCP23017
+// Created in setup(), because Wire doesn't work until then.
+BufferedMCP23017* expander;
+Input* expanderInput;
+Output* expanderOutput;
+#endif
+
+// SECTION The benchmarks. Each performs one call of the method being measured.
+
+void empty() {}
+
+void simpleInputGet() { booleanSink = simpleInput->get(); }
+void debouncedInputGet() { booleanSink = debouncedInput->get(); }
+void inputButtonPressed() { booleanSink = inputButton->pressed(); }
+void simpleOutputSet() { simpleOutput->set( toggle = ! toggle ); }
+
+void simpleAnalogInputGet() { floatSink = simpleAnalogInput->get(); }
+void clippedAnalogInputGet() { floatSink = clippedAnalogInput->get(); }
+void scaledAnalogInputGet() { floatSink = scaledAnalogInput->get(); }
+void easedAnalogInputGet() { floatSink = easedAnalogInput->get(); }
+void fusedAnalogInputGet() { floatSink = fusedAnalogInput->get(); }
+void fixedAnalogInputGet() { fixedSink = fixedAnalogInput->get(); }
+void clippedFixedAnalogInputGet() { fixedSink = clippedFixedAnalogInput->get(); }
+
+void simplePWMOutputSet() { simplePWMOutput->set( floatSource ); }
+void scaledPWMOutputSet() { scaledPWMOutput->set( floatSource ); }
+void easedPWMOutputSet() { easedPWMOutput->set( floatSource ); }
+void fixedPWMOutputSet() { fixedPWMOutput->set( fixedSource ); }
+void easedFixedPWMOutputSet() { easedFixedPWMOutput->set( fixedSource ); }
+
+void linearEase() { floatSink = linear.ease( floatSource ); }
+void jumpEase() { floatSink = jump.ease( floatSource ); }
+void easeInQuadEase() { floatSink = easeInQuad.ease( floatSource ); }
+void easeInCubicEase() { floatSink = easeInCubic.ease( floatSource ); }
+void easeInQuartEase() { floatSink = easeInQuart.ease( floatSource ); }
+void easeOutQuadEase() { floatSink = easeOutQuad.ease( floatSource ); }
+void easeOutCubicEase() { floatSink = easeOutCubic.ease( floatSource ); }
+void easeOutQuartEase() { floatSink = easeOutQuart.ease( floatSource ); }
+void tabulatedEaseEase() { floatSink = tabulatedEase->ease( floatSource ); }
+void tabulatedEaseEaseByte() { byteSink = tabulatedEase->easeByte( byteSource ); }
+void fixedEaseInQuadEase() { fixedSink = fixedEaseInQuad.ease( fixedSource ); }
+
+void shiftRegisterOutput1() { shiftRegister->output( shiftBuffer[0] ++ ); }
+void shiftRegisterOutput2() { shiftBuffer[0] ++; shiftRegister->output( 2, shiftBuffer ); }
+void spiShiftRegisterOutput2() { shiftBuffer[0] ++; spiShiftRegister->output( 2, shiftBuffer ); }
+void bufferedShiftRegisterUpdateChanged() { bufferedShiftRegister->set( 0, toggle = ! toggle ); bufferedShiftRegister->update(); }
+void bufferedShiftRegisterUpdateUnchanged() { bufferedShiftRegister->update(); }
+void spiBufferedShiftRegisterUpdateChanged() { spiBufferedShiftRegister->set( 0, toggle = ! toggle ); spiBufferedShiftRegister->update(); }
+
+// The Mux benchmarks step through the addresses, as the cost of select() can depend on the previous address.
+void addressMuxGet() { booleanSink = addressMux->get( address ++ & 7 ); }
+void addressMuxScanAll() { muxBits = addressMux->scanAll( 8 ); }
+void booleanMuxGet() { booleanSink = booleanMux->get( address ++ & 1 ); }
+void shiftRegisterMuxGet() { booleanSink = shiftRegisterMux->get( address ++ & 15 ); }
+void wholeBytesMuxGet() { booleanSink = wholeBytesMux->get( address ++ & 15 ); }
+void comboMuxGet() { booleanSink = comboMux->get( address ++ & 31 ); }
+void analogMuxGet() { floatSink = analogMux->get( address ++ & 7 ); }
+void analogMuxScanAll() { analogMux->scanAll( 8, analogValues ); }
+
+#ifdef BENCHMARK_MCP23017
+void mcp23017Fetch() { expander->fetch(); }
+void mcp23017FlushChanged() { expander->digitalWrite( 8, toggle = ! toggle ); expander->flush(); }
+void mcp23017FlushUnchanged() { expander->flush(); }
+void mcp23017Frame() { i2cBus.beginFrame(); expanderOutput->set( expanderInput->get() ); i2cBus.endFrame(); }
+#endif
+
+// SECTION The harness
+
+unsigned long baselineMicros; // The time taken by defaultCalls calls to empty().
+
+#ifdef simulation_h
+uint64_t hostNanos; // The real time taken by the last measure().
+uint64_t baselineHostNanos;
+#endif
+
+unsigned long measure( void (*function)(), int calls )
+{
+    function(); // Warm up, so that one-off work (such as the first update of a buffer) isn't measured.
+    #ifdef simulation_h
+    simulation.reset();
+    uint64_t hostStart = simulation.hostNanos();
+    #endif
+
+    unsigned long start = micros();
+    for ( int i = 0; i < calls; i ++ ) {
+        function();
+    }
+    unsigned long elapsed = micros() - start;
+
+    #ifdef simulation_h
+    hostNanos = simulation.hostNanos() - hostStart;
+    #endif
+    return elapsed;
+}
+
+void benchmark( const char* name, void (*function)(), int calls = defaultCalls )
+{
+    long elapsed = (long) measure( function, calls ) - (long) ( baselineMicros * (long) calls / defaultCalls );
+    if ( elapsed < 0 ) {
+        elapsed = 0;
+    }
+
+    Serial.print( name ); Serial.print( "," );
+    Serial.print( calls ); Serial.print( "," );
+    Serial.print( elapsed ); Serial.print( "," );
+    Serial.print( elapsed * 1000 / calls );
+    #ifdef simulation_h
+    SimCounters& counters = simulation.counters;
+    Serial.print( "," ); Serial.print( counters.digitalReads );
+    Serial.print( "," ); Serial.print( counters.digitalWrites );
+    Serial.print( "," ); Serial.print( counters.analogReads );
+    Serial.print( "," ); Serial.print( counters.analogWrites );
+    Serial.print( "," ); Serial.print( counters.shiftOuts );
+    Serial.print( "," ); Serial.print( counters.i2cBytes );
+    Serial.print( "," ); Serial.print( counters.i2cTransactions );
+    Serial.print( "," ); Serial.print( counters.spiBytes );
+    long hostElapsed = (long) hostNanos - (long) ( baselineHostNanos * calls / defaultCalls );
+    Serial.print( "," ); Serial.print( hostElapsed < 0 ? 0L : hostElapsed / calls );
+    #endif
+    Serial.println();
+}
+
+void setup()
+{
+    Serial.begin( 9600 );
+
+    #ifdef BENCHMARK_MCP23017
+    expander = new BufferedMCP23017( 0 );
+    expander->beginConfiguration();
+    expanderInput = expander->createInput( 0, LOW, true );
+    expanderOutput = expander->createOutput( 8 );
+    expander->endConfiguration();
+    #endif
+
+    baselineMicros = measure( empty, defaultCalls );
+    #ifdef simulation_h
+    baselineHostNanos = hostNanos;
+    #endif
+
+    Serial.println( "# AbstractIO benchmark" );
+    Serial.print( "# F_CPU " ); Serial.println( (unsigned long) F_CPU );
+    Serial.print( "# baselineMicros " ); Serial.println( baselineMicros );
+    #ifdef simulation_h
+    Serial.println( "# Simulated. micros and nanosPerCall only include the cost of the I/O." );
+    Serial.println( "# hostNanosPerCall is the real time on this PC (not an Arduino)." );
+    Serial.println( "name,calls,micros,nanosPerCall,digitalReads,digitalWrites,analogReads,analogWrites,shiftOuts,i2cBytes,i2cTransactions,spiBytes,hostNanosPerCall" );
+    #else
+    Serial.println( "name,calls,micros,nanosPerCall" );
+    #endif
+
+    benchmark( "SimpleInput get", simpleInputGet );
+    benchmark( "DebouncedInput get", debouncedInputGet );
+    benchmark( "InputButton pressed", inputButtonPressed );
+    benchmark( "SimpleOutput set", simpleOutputSet );
+
+    // analogRead takes about 100us, so these use fewer calls.
+    benchmark( "SimpleAnalogInput get", simpleAnalogInputGet, 100 );
+    benchmark( "ClippedAnalogInput get", clippedAnalogInputGet, 100 );
+    benchmark( "ScaledAnalogInput get", scaledAnalogInputGet, 100 );
+    benchmark( "EasedAnalogInput get", easedAnalogInputGet, 100 );
+    benchmark( "FusedAnalogInput get", fusedAnalogInputGet, 100 );
+    benchmark( "SimpleFixedAnalogInput get", fixedAnalogInputGet, 100 );
+    benchmark( "ClippedFixedAnalogInput get", clippedFixedAnalogInputGet, 100 );
+
+    benchmark( "SimplePWMOutput set", simplePWMOutputSet );
+    benchmark( "ScaledPWMOutput set", scaledPWMOutputSet );
+    benchmark( "EasedPWMOutput set", easedPWMOutputSet );
+    benchmark( "SimpleFixedPWMOutput set", fixedPWMOutputSet );
+    benchmark( "EasedFixedPWMOutput set", easedFixedPWMOutputSet );
+
+    benchmark( "Linear ease", linearEase );
+    benchmark( "Jump ease", jumpEase );
+    benchmark( "EaseInQuad ease", easeInQuadEase );
+    benchmark( "EaseInCubic ease", easeInCubicEase );
+    benchmark( "EaseInQuart ease", easeInQuartEase );
+    benchmark( "EaseOutQuad ease", easeOutQuadEase );
+    benchmark( "EaseOutCubic ease", easeOutCubicEase );
+    benchmark( "EaseOutQuart ease", easeOutQuartEase );
+    benchmark( "TabulatedEase ease", tabulatedEaseEase );
+    benchmark( "TabulatedEase easeByte", tabulatedEaseEaseByte );
+    benchmark( "FixedEaseInQuad ease", fixedEaseInQuadEase );
+
+    benchmark( "ShiftRegister output 1 byte", shiftRegisterOutput1 );
+    benchmark( "ShiftRegister output 2 bytes", shiftRegisterOutput2 );
+    benchmark( "SPIShiftRegister output 2 bytes", spiShiftRegisterOutput2 );
+    benchmark( "BufferedShiftRegister update changed", bufferedShiftRegisterUpdateChanged );
+    benchmark( "BufferedShiftRegister update unchanged", bufferedShiftRegisterUpdateUnchanged );
+    benchmark( "BufferedShiftRegister SPI update changed", spiBufferedShiftRegisterUpdateChanged );
+
+    benchmark( "Mux AddressSelector get", addressMuxGet );
+    benchmark( "Mux AddressSelector scanAll 8", addressMuxScanAll );
+    benchmark( "Mux BooleanSelector get", booleanMuxGet );
+    benchmark( "Mux ShiftRegisterSelector get", shiftRegisterMuxGet );
+    benchmark( "Mux ShiftRegisterSelector wholeBytes get", wholeBytesMuxGet );
+    benchmark( "Mux ComboSelector get", comboMuxGet );
+    benchmark( "AnalogMux AddressSelector get", analogMuxGet, 100 );
+    benchmark( "AnalogMux AddressSelector scanAll 8", analogMuxScanAll, 10 );
+
+    #ifdef BENCHMARK_MCP23017
+    benchmark( "BufferedMCP23017 fetch", mcp23017Fetch, 100 );
+    benchmark( "BufferedMCP23017 flush changed", mcp23017FlushChanged, 100 );
+    benchmark( "BufferedMCP23017 flush unchanged", mcp23017FlushUnchanged, 100 );
+    benchmark( "I2CBus frame", mcp23017Frame, 100 );
+    #endif
+
+    Serial.println( "# END" );
+}
+
+void loop()
+{
+}
@@ -0,0 +1,43 @@
+#include <abstractIO.h>
+#include <abstractButtonEvents.cpp.h>
+
+/*
+Prints an event to the serial console whenever a button is pressed or released.
+
+Connect buttons (to ground) on pins 4, 5 and 6. These are monitored using pin change interrupts.
+Connect 8 more buttons via a 4051 multiplexer, with address pins 13, 12, 11 and its output to pin 10.
+These are polled.
+*/
+
+ButtonEventQueue events( 20 /* debounce milliseconds */ );
+
+void setup()
+{
+    Serial.begin( 9600 );
+
+    events.addPin( 4 ); // id 0
+    events.addPin( 5 ); // id 1
+    events.addPin( 6 ); // id 2
+
+    Mux* mux = (new AddressSelector( 13, 12, 11 ))->createMux( 10 );
+    for ( int i = 0; i < 8; i ++ ) {
+        events.addInput( mux->createInput( i ) ); // ids 3..10
+    }
+}
+
+void loop()
+{
+    events.poll();
+
+    ButtonEvent event;
+    while ( events.pollEvent( &event ) ) {
+        Serial.print( event.time );
+        Serial.print( " Button " ); Serial.print( event.id );
+        Serial.println( event.pressed ? " pressed" : " released" );
+    }
+
+    if ( events.overflows ) {
+        Serial.print( "Lost events : " ); Serial.println( events.overflows );
+        events.overflows = 0;
+    }
+}
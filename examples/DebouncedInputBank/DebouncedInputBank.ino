@@ -0,0 +1,68 @@
+#include <abstractIO.h>
+#include <abstractDebounce.h>
+
+/*
+Compares the speed of debouncing 'count' buttons using a DebouncedInput for each button, with a single
+DebouncedInputBank.
+
+Each "frame" reads every button, just like a loop() which checks lots of switches.
+For the DebouncedInputBank, the frame also includes the call to update(), which reads and debounces them all.
+
+The results are printed to the serial console as debounced reads per second.
+No wiring is needed, the pins are left floating (with their pullups enabled).
+*/
+
+const int count = 12;
+const long frames = 1000;
+
+byte pins[count] = { 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
+
+Input* debouncedInputs[count];
+Input* bankInputs[count];
+
+DebouncedInputBank bank( 50 );
+
+volatile boolean sink; // Prevents the compiler from optimising away the reads.
+
+void setup()
+{
+    Serial.begin( 9600 );
+
+    for ( int i = 0; i < count; i ++ ) {
+        Input* input = new SimpleInput( pins[i] );
+        debouncedInputs[i] = input->debounced();
+        bankInputs[i] = bank.createInput( input );
+    }
+}
+
+void report( const char* name, unsigned long micros )
+{
+    Serial.print( name );
+    Serial.print( " : " );
+    Serial.print( micros );
+    Serial.print( "us. Reads per second : " );
+    Serial.println( (unsigned long) (frames * count * 1000000.0 / micros) );
+}
+
+void loop()
+{
+    unsigned long start = micros();
+    for ( long f = 0; f < frames; f ++ ) {
+        for ( int i = 0; i < count; i ++ ) {
+            sink = debouncedInputs[i]->get();
+        }
+    }
+    report( "DebouncedInput    ", micros() - start );
+
+    start = micros();
+    for ( long f = 0; f < frames; f ++ ) {
+        bank.update();
+        for ( int i = 0; i < count; i ++ ) {
+            sink = bankInputs[i]->get();
+        }
+    }
+    report( "DebouncedInputBank", micros() - start );
+
+    Serial.println();
+    delay( 2000 );
+}
@@ -0,0 +1,49 @@
+#include <abstractIO.h>
+#include <abstractFixed.h>
+
+/*
+Fades an LED on pin 9 using a potentiometer on A0, just like the FadeLED example, but using fixed point
+maths (q15 values), rather than floats.
+
+Every couple of seconds, the time taken by the float and fixed point versions of the same pipeline
+(clip, then easeInQuart) is printed to the serial console.
+*/
+
+FixedAnalogInput* knob = (new SimpleFixedAnalogInput( A0 ))->clip( FLOAT_TO_Q15( 0.1 ), FLOAT_TO_Q15( 0.9 ) );
+FixedPWMOutput* led = (new SimpleFixedPWMOutput( 9 ))->ease( &fixedEaseInQuart );
+
+// For comparison, the same using floats.
+AnalogInput* floatKnob = (new SimpleAnalogInput( A0 ))->clip( 0.1, 0.9 )->ease( &easeInQuart );
+
+const int samples = 100;
+
+volatile float floatSink; // Prevents the compiler from optimising away the calculations.
+volatile q15 fixedSink;
+
+void setup()
+{
+    Serial.begin( 9600 );
+}
+
+void loop()
+{
+    for ( int i = 0; i < 1000; i ++ ) {
+        led->set( knob->get() );
+    }
+
+    // NOTE. Both include the time for analogRead, which is about 100us.
+    unsigned long start = micros();
+    for ( int i = 0; i < samples; i ++ ) {
+        floatSink = floatKnob->get();
+    }
+    unsigned long floatTime = micros() - start;
+
+    start = micros();
+    for ( int i = 0; i < samples; i ++ ) {
+        fixedSink = fixedEaseInQuart.ease( knob->get() );
+    }
+    unsigned long fixedTime = micros() - start;
+
+    Serial.print( "Float : " ); Serial.print( floatTime / samples );
+    Serial.print( "us Fixed : " ); Serial.print( fixedTime / samples ); Serial.println( "us" );
+}
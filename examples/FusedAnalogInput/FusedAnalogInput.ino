@@ -0,0 +1,77 @@
+#include <abstractIO.h>
+
+/*
+Compares the speed of a chain of AnalogInput wrappers :
+    input->clip( 0.2, 0.8 )->scale( 255 )->ease( &easeInQuad )
+with the equivalent FusedAnalogInput :
+    input->fused( 0.2, 0.8, 255, &easeInQuad )
+
+analogRead takes about 100 microseconds, which would swamp the differences, so the source is a "fake"
+AnalogInput, which sweeps through the range 0..1.
+
+The results are printed to the serial console, as well as the largest difference between the two.
+No wiring is needed.
+*/
+
+class SweepAnalogInput : public AnalogInput
+{
+  public :
+    int counter = 0;
+
+    virtual float get()
+    {
+        counter = (counter + 1) % 1024;
+        return counter / 1023.0f;
+    }
+};
+
+const long samples = 1000;
+
+SweepAnalogInput sweep;
+
+AnalogInput* chain = sweep.clip( 0.2, 0.8 )->scale( 255 )->ease( &easeInQuad );
+AnalogInput* fused = sweep.fused( 0.2, 0.8, 255, &easeInQuad );
+
+volatile float sink; // Prevents the compiler from optimising away the calculations.
+
+void setup()
+{
+    Serial.begin( 9600 );
+
+    float maxDifference = 0;
+    for ( int i = 0; i < 1024; i ++ ) {
+        float a = chain->get();
+        float b = fused->get();
+        float difference = a > b ? a - b : b - a;
+        if ( difference > maxDifference ) {
+            maxDifference = difference;
+        }
+    }
+    Serial.print( "Largest difference : " ); Serial.println( maxDifference, 6 );
+}
+
+void report( const char* name, unsigned long micros )
+{
+    Serial.print( name );
+    Serial.print( " : " );
+    Serial.print( micros / (float) samples );
+    Serial.println( "us per sample" );
+}
+
+void loop()
+{
+    unsigned long start = micros();
+    for ( long i = 0; i < samples; i ++ ) {
+        sink = chain->get();
+    }
+    report( "Chain", micros() - start );
+
+    start = micros();
+    for ( long i = 0; i < samples; i ++ ) {
+        sink = fused->get();
+    }
+    report( "Fused", micros() - start );
+
+    Serial.println();
+    delay( 2000 );
+}
@@ -0,0 +1,66 @@
+/*
+Uses two BufferedMCP23017s, which are read and written once per loop, using i2cBus.beginFrame() and endFrame().
+Each second, the number of I2C transactions and bytes used by the last frame are printed to the serial console.
+
+Connect I2C clock (A5) to pin 12 of both MCP23017s and I2C data (A4) to pin 13 of both MCP23017s.
+Tie the address pins (15, 16 and 17) of the first chip to ground, and of the second chip, tie pin 15 to 5V, and
+16 and 17 to ground (so its address is 1).
+Connect buttons to data line 0 (pin 21) of each chip, and LEDs (via resistors) from data line 8 (pin 1) to ground.
+*/
+
+#include <Wire.h>
+#include <abstractIO.h>
+#include <abstractMCP23017.cpp.h>
+
+BufferedMCP23017* expanderA = new BufferedMCP23017( 0 );
+BufferedMCP23017* expanderB = new BufferedMCP23017( 1 );
+
+// Created in setup(), because Wire doesn't work until then.
+Input* buttonA;
+Input* buttonB;
+Output* ledA;
+Output* ledB;
+
+void report()
+{
+    Serial.print( "Transactions per frame : " );
+    Serial.print( i2cBus.frameTransactions );
+    Serial.print( " Bytes per frame : " );
+    Serial.println( i2cBus.frameBytes );
+}
+
+RunPeriodically reporter( 1000, report );
+
+void setup()
+{
+    Serial.begin( 9600 );
+    i2cBus.setClock( 400000 );
+
+    // The configuration changes are sent to each chip in a single I2C transaction, at endConfiguration().
+    expanderA->beginConfiguration();
+    expanderB->beginConfiguration();
+    buttonA = expanderA->createInput( 0, LOW, true );
+    buttonB = expanderB->createInput( 0, LOW, true );
+    ledA = expanderA->createOutput( 8 );
+    ledB = expanderB->createOutput( 8 );
+    expanderA->endConfiguration();
+    expanderB->endConfiguration();
+
+    // Optional : Connect INTA (pin 20) of both chips to Arduino pin 2, and then the chips are only read when a button
+    // has changed, so most frames need no I2C transactions at all.
+    // expanderA->useInterrupt( 2 );
+    // expanderB->useInterrupt( 2 );
+}
+
+void loop()
+{
+    i2cBus.beginFrame(); // Reads both expanders
+
+    // Each button lights the LED on the other chip.
+    ledA->set( buttonB->get() );
+    ledB->set( buttonA->get() );
+
+    i2cBus.endFrame(); // Writes the outputs (only if they have changed).
+
+    reporter.run();
+}
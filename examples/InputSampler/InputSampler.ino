@@ -0,0 +1,66 @@
+// Printing to the serial console is slow, so use a large ring buffer, so that no frames are lost.
+#define ABSTRACT_SAMPLER_INPUTS 16
+#define ABSTRACT_SAMPLER_FRAMES 128
+
+#include <abstractIO.h>
+#include <abstractSampler.cpp.h>
+
+/*
+Samples 4 switches (on pins 4..7) and 8 multiplexed switches (a 4051 with address pins 13, 12, 11, and its
+output on pin 10) at about 1kHz, in the background.
+
+Every frame is processed in order, to count how many times each switch was pressed, so even very short presses
+are counted, even though loop() is slow.
+*/
+
+InputSampler sampler;
+
+Mux* mux = (new AddressSelector( 13, 12, 11 ))->createMux( 10 );
+
+Input* switchA = sampler.createInput( new SimpleInput( 4 ) );
+
+int presses[12];
+
+void report();
+RunPeriodically reporter( 500, report );
+
+void setup()
+{
+    Serial.begin( 9600 );
+
+    for ( int i = 5; i <= 7; i ++ ) {
+        sampler.createInput( new SimpleInput( i ) );
+    }
+    for ( int i = 0; i < 8; i ++ ) {
+        sampler.createInput( mux->createInput( i ) );
+    }
+    sampler.begin();
+}
+
+SamplerFrame previous = 0;
+
+void loop()
+{
+    SamplerFrame frame;
+    while ( sampler.read( &frame ) ) {
+        SamplerFrame pressed = frame & ~previous; // The bits which have just changed from 0 to 1.
+        for ( int i = 0; i < 12; i ++ ) {
+            if ( pressed & ((SamplerFrame) 1 << i) ) {
+                presses[i] ++;
+            }
+        }
+        previous = frame;
+    }
+
+    reporter.run();
+}
+
+void report()
+{
+    Serial.print( "Switch A : " ); Serial.print( switchA->get() );
+    Serial.print( " Presses : " );
+    for ( int i = 0; i < 12; i ++ ) {
+        Serial.print( presses[i] ); Serial.print( " " );
+    }
+    Serial.print( " Overflows : " ); Serial.println( sampler.overflows );
+}
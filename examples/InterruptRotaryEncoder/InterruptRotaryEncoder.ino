@@ -0,0 +1,27 @@
+#include <abstractIO.h>
+#include <abstractRotaryEncoder.h>
+#include <abstractPinChange.cpp.h>
+
+/*
+Two rotary encoders, monitored using pin change interrupts, so that no steps are missed,
+even though loop() is very slow.
+
+Connect the first encoder to pins 4 and 5, and the second to pins 6 and 7 (the common pin to ground).
+*/
+
+RotaryEncoder* re1 = new InterruptRotaryEncoder( 4, 5 );
+RotaryEncoder* re2 = new InterruptRotaryEncoder( 6, 7 );
+
+void setup()
+{
+    Serial.begin(9600);
+}
+
+void loop()
+{
+    Serial.print( re1->get() );
+    Serial.print( " " );
+    Serial.println( re2->get() );
+
+    delay( 1000 ); // A very slow loop, but no steps are missed.
+}
@@ -0,0 +1,82 @@
+/*
+Compares an MCP23017 (I2C) with an MCP23S17 (SPI). Both chips are used in exactly the same way (via
+BufferedMCP23017), only the bus differs. Each second, the time taken by the last frame on each bus (i.e. reading
+the inputs and writing the outputs) is printed to the serial console, along with the bytes and transactions used.
+
+MCP23017 : Connect I2C clock (A5) to pin 12 and I2C data (A4) to pin 13. Tie the address pins (15, 16 and 17) to ground.
+MCP23S17 : Connect SCK (13) to pin 12, MOSI (11) to pin 13 (SI), MISO (12) to pin 14 (SO), and Arduino pin 10 to pin 11 (CS).
+Tie the address pins (15, 16 and 17) to ground.
+On both chips, tie RESET (pin 18) to 5V, connect a button to data line 0 (pin 21), and an LED (via a resistor)
+from data line 8 (pin 1) to ground.
+*/
+
+#include <Wire.h>
+#include <SPI.h>
+#include <abstractIO.h>
+#include <abstractMCP23017.cpp.h>
+#include <abstractMCP23S17.cpp.h>
+
+MCP23S17Bus spiBus( 10 );
+
+BufferedMCP23017* i2cExpander = new BufferedMCP23017( 0 );
+BufferedMCP23017* spiExpander = new BufferedMCP23017( 0, &spiBus );
+
+// Created in setup(), because Wire and SPI don't work until then.
+Input* i2cButton;
+Input* spiButton;
+Output* i2cLED;
+Output* spiLED;
+
+unsigned long i2cMicros;
+unsigned long spiMicros;
+boolean toggle;
+
+void report()
+{
+    Serial.print( "I2C : " ); Serial.print( i2cMicros ); Serial.print( "us " );
+    Serial.print( i2cBus.frameTransactions ); Serial.print( " transactions " );
+    Serial.print( i2cBus.frameBytes ); Serial.print( " bytes. " );
+
+    Serial.print( "SPI : " ); Serial.print( spiMicros ); Serial.print( "us " );
+    Serial.print( spiBus.frameTransactions ); Serial.print( " transactions " );
+    Serial.print( spiBus.frameBytes ); Serial.println( " bytes." );
+}
+
+RunPeriodically reporter( 1000, report );
+
+void setup()
+{
+    Serial.begin( 9600 );
+    i2cBus.setClock( 400000 );
+
+    i2cExpander->beginConfiguration();
+    i2cButton = i2cExpander->createInput( 0, LOW, true );
+    i2cLED = i2cExpander->createOutput( 8 );
+    i2cExpander->endConfiguration();
+
+    spiExpander->beginConfiguration();
+    spiButton = spiExpander->createInput( 0, LOW, true );
+    spiLED = spiExpander->createOutput( 8 );
+    spiExpander->endConfiguration();
+}
+
+void loop()
+{
+    // The LEDs are normally lit, and blink (once per frame, which is too fast to see) while the button is pressed,
+    // so that each frame includes a write as well as a read.
+    toggle = ! toggle;
+
+    unsigned long start = micros();
+    i2cBus.beginFrame();
+    i2cLED->set( ! i2cButton->get() || toggle );
+    i2cBus.endFrame();
+    i2cMicros = micros() - start;
+
+    start = micros();
+    spiBus.beginFrame();
+    spiLED->set( ! spiButton->get() || toggle );
+    spiBus.endFrame();
+    spiMicros = micros() - start;
+
+    reporter.run();
+}
@@ -27,5 +27,11 @@ void loop()
     if (b2->released()) {
       Serial.println( "Button 2 released" );
     }
+
+    // Alternatively, read all 8 inputs in one go. Bit n of the result is input n.
+    MuxBits all = mux->scanAll( 8 );
+    if (all & 0x80) {
+        Serial.println( "Input 7 set" );
+    }
 }
 
@@ -0,0 +1,41 @@
+/*
+Reads 16 buttons using two 74HC165 shift registers, chained together.
+
+Wiring : 74HC165 Q7 (pin 9) to Arduino pin 2, CP (pin 2) to Arduino pin 4, PL (pin 1) to Arduino pin 3.
+CE (pin 15) to GND. Connect Q7 of the second chip to DS (pin 10) of the first.
+Each button connects one of the D0..D7 inputs to GND, with a pullup resistor to 5V.
+*/
+
+#include <abstractIO.h>
+#include <abstractShiftRegister.h>
+
+// The number of 165 shift registers chained together.
+const int byteCount = 2;
+
+ParallelInShiftRegister *inputs = new ParallelInShiftRegister( 2 /*data*/, 4 /*clock*/, 3 /*load*/, byteCount );
+
+// The buttons pull the inputs LOW when pressed.
+BufferedInput** buttons = inputs->createInputs( LOW );
+
+// Input objects can be wrapped in the usual way.
+Button* fire = inputs->createInput( 0, LOW )->button();
+
+void setup()
+{
+    Serial.begin( 9600 );
+}
+
+void loop()
+{
+    inputs->read(); // Reads all 16 inputs in one go.
+
+    for ( int i = 0; i < byteCount * 8; i ++ ) {
+        Serial.print( buttons[i]->get() ? "X" : "." );
+    }
+    Serial.println();
+
+    if ( fire->pressed() ) {
+        Serial.println( "Fire!" );
+    }
+    delay( 100 );
+}
@@ -0,0 +1,74 @@
+#include <abstractIO.h>
+#include <abstractPort.h>
+
+/*
+Compares the speed of SimpleInput with PortInput (created by a PortInputBank).
+
+Each "frame" reads 'count' inputs, just like a loop() which checks lots of switches.
+For the PortInputBank, the frame also includes the call to read(), which takes the snapshot of the ports.
+
+The results are printed to the serial console as reads per second.
+No wiring is needed, the pins are left floating (with their pullups enabled).
+*/
+
+const int count = 12;
+const long frames = 1000;
+
+byte pins[count] = { 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
+
+Input* simpleInputs[count];
+Input* portInputs[count];
+
+PortInputBank bank;
+
+volatile boolean sink; // Prevents the compiler from optimising away the reads.
+
+void setup()
+{
+    Serial.begin( 9600 );
+
+    for ( int i = 0; i < count; i ++ ) {
+        simpleInputs[i] = new SimpleInput( pins[i] );
+        portInputs[i] = bank.createInput( pins[i] );
+    }
+
+    // Check that both kinds of Input agree.
+    bank.read();
+    for ( int i = 0; i < count; i ++ ) {
+        if ( simpleInputs[i]->get() != portInputs[i]->get() ) {
+            Serial.print( "Mismatch on pin " ); Serial.println( pins[i] );
+        }
+    }
+}
+
+void report( const char* name, unsigned long micros )
+{
+    Serial.print( name );
+    Serial.print( " : " );
+    Serial.print( micros );
+    Serial.print( "us. Reads per second : " );
+    Serial.println( (unsigned long) (frames * count * 1000000.0 / micros) );
+}
+
+void loop()
+{
+    unsigned long start = micros();
+    for ( long f = 0; f < frames; f ++ ) {
+        for ( int i = 0; i < count; i ++ ) {
+            sink = simpleInputs[i]->get();
+        }
+    }
+    report( "SimpleInput", micros() - start );
+
+    start = micros();
+    for ( long f = 0; f < frames; f ++ ) {
+        bank.read();
+        for ( int i = 0; i < count; i ++ ) {
+            sink = portInputs[i]->get();
+        }
+    }
+    report( "PortInput  ", micros() - start );
+
+    Serial.println();
+    delay( 2000 );
+}
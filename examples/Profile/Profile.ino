@@ -0,0 +1,56 @@
+/*
+Shows which objects are using the loop's time. Once a second, a single frame is profiled, and each profiled
+object's hardware operations (pin reads and writes, ADC conversions, shifted bytes, I2C bytes and transactions)
+and time are printed to the serial console, e.g. :
+
+    button : calls 1 micros 20 digitalReads 1 digitalWrites 2 analogReads 0 analogWrites 0 shiftedBytes 0 busBytes 0 busTransactions 0
+
+NOTE. Profiling is disabled by default. Uncomment "#define ABSTRACT_PROFILE" in abstractIO.h first.
+When it is disabled, this sketch still works, but profiled() does nothing, and nothing is reported.
+
+Wiring : A 4051 multiplexer with address pins 2, 3 and 4, and the common pin connected to pin 5, with a button
+(to ground) on channel 3. A potentiometer on A0, and an LED (via a resistor) on pin 9.
+An MCP23017 (see the MCP23017 example), with an LED on data line 8 (pin 1).
+*/
+
+#include <Wire.h>
+#include <abstractIO.h>
+#include <abstractMCP23017.cpp.h>
+
+// The counts are inclusive, so "debounced button" includes the operations performed by "button".
+Mux* mux = (new AddressSelector( 2, 3, 4 ))->createMux( 5 );
+Input* button = mux->createInput( 3 )->profiled( "button" )->debounced()->profiled( "debounced button" );
+
+AnalogInput* knob = (new SimpleAnalogInput( A0 ))->ease( &easeInQuad )->profiled( "knob" );
+PWMOutput* led = (new SimplePWMOutput( 9 ))->profiled( "led" );
+
+MCP23017* expander = new MCP23017( 0 );
+Output* expanderLED; // Created in setup(), because Wire doesn't work until then.
+
+#ifdef ABSTRACT_PROFILE
+// Any block of code can be profiled too, using begin() and end().
+IOProfile frame( "frame" );
+#endif
+
+void setup()
+{
+    Serial.begin( 9600 );
+    expanderLED = expander->createOutput( 8 )->profiled( "expander LED" );
+}
+
+void loop()
+{
+    #ifdef ABSTRACT_PROFILE
+    frame.begin();
+    #endif
+
+    expanderLED->set( button->get() );
+    led->set( knob->get() );
+
+    #ifdef ABSTRACT_PROFILE
+    frame.end();
+    abstractProfiler.report();
+    #endif
+
+    delay( 1000 );
+}
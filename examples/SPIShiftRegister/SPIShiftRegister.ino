@@ -0,0 +1,55 @@
+/*
+Compares the speed of a bit-banged LatchedShiftRegister with a LatchedSPIShiftRegister, sending
+12 bytes (e.g. a chain of 12 74HC595s driving an LED panel).
+
+Wiring for the SPI version : 74HC595 data (pin 14) to MOSI (pin 11 on an Uno), clock (pin 11) to SCK (pin 13 on an Uno),
+and latch (pin 12) to pin 3.
+The bit-banged version uses pins 2 (data), 4 (clock) and 5 (latch), so both can be wired at the same time.
+
+The results are printed to the serial console.
+*/
+
+#include <SPI.h>
+#include <abstractIO.h>
+#include <abstractSPIShiftRegister.cpp.h>
+
+const byte byteCount = 12;
+const int frames = 100;
+
+ShiftRegister* bitBanged = new LatchedShiftRegister( 2 /*data pin */, 4 /*clock pin*/, 5 /*latch pin*/ );
+ShiftRegister* spi = new LatchedSPIShiftRegister( 3 /*latch pin*/, 8000000 );
+
+byte buffer[byteCount];
+
+void setup()
+{
+    Serial.begin( 9600 );
+}
+
+void report( const char* name, unsigned long micros )
+{
+    Serial.print( name );
+    Serial.print( " : " );
+    Serial.print( micros / (float) frames );
+    Serial.println( "us per frame" );
+}
+
+void loop()
+{
+    unsigned long start = micros();
+    for ( int f = 0; f < frames; f ++ ) {
+        buffer[0] = f;
+        bitBanged->output( byteCount, buffer );
+    }
+    report( "shiftOut", micros() - start );
+
+    start = micros();
+    for ( int f = 0; f < frames; f ++ ) {
+        buffer[0] = f;
+        spi->output( byteCount, buffer );
+    }
+    report( "SPI     ", micros() - start );
+
+    Serial.println();
+    delay( 2000 );
+}
@@ -0,0 +1,134 @@
+/*
+ * A stand-in for the Arduino core, so that AbstractIO can be built and run on a PC (Linux), without any hardware.
+ *
+ * The pins are "virtual" (see simulation.h), and every call which would touch the hardware (digitalRead,
+ * digitalWrite, shiftOut, analogRead, ...) is counted, and advances a simulated clock by roughly the number of
+ * cycles it would take on a 16MHz Uno. millis() and micros() return the simulated time.
+ *
+ * This is NOT an AVR, so ABSTRACT_PORT_REGISTERS is not defined, and AbstractIO uses its portable
+ * (digitalRead/digitalWrite) code. The .cpp.h files which need interrupts (abstractPinChange, abstractSampler,
+ * abstractButtonEvents and abstractAsyncI2C) are therefore not supported (pinchange.cpp fakes just enough of an
+ * Uno's registers to test abstractPinChange).
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+// The same pin numbers as an Uno.
+#define NUM_DIGITAL_PINS 20
+#define NOT_A_PIN 0
+#define NOT_A_PORT 0
+
+static const uint8_t A0 = 14;
+static const uint8_t A1 = 15;
+static const uint8_t A2 = 16;
+static const uint8_t A3 = 17;
+static const uint8_t A4 = 18;
+static const uint8_t A5 = 19;
+
+static const uint8_t SS = 10;
+static const uint8_t MOSI = 11;
+static const uint8_t MISO = 12;
+static const uint8_t SCK = 13;
+
+static const uint8_t SDA = 18;
+static const uint8_t SCL = 19;
+
+#define LED_BUILTIN 13
+
+#define PROGMEM
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper*) (s))
+#define pgm_read_byte(address) (*(const uint8_t*) (address))
+#define pgm_read_word(address) (*(const uint16_t*) (address))
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define _BV(bit) (1 << (bit))
+
+void pinMode( uint8_t pin, uint8_t mode );
+void digitalWrite( uint8_t pin, uint8_t value );
+int digitalRead( uint8_t pin );
+int analogRead( uint8_t pin );
+void analogWrite( uint8_t pin, int value );
+
+void shiftOut( uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t value );
+uint8_t shiftIn( uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder );
+
+unsigned long millis();
+unsigned long micros();
+void delay( unsigned long ms );
+void delayMicroseconds( unsigned int us );
+
+// There are no interrupts, so these do nothing.
+void noInterrupts();
+void interrupts();
+
+long map( long x, long inMin, long inMax, long outMin, long outMax );
+long random( long max );
+long random( long min, long max );
+void randomSeed( unsigned long seed );
+
+/*
+ * Serial output goes to stdout.
+ */
+class Print
+{
+  public :
+    void begin( unsigned long baud );
+
+    void print( const __FlashStringHelper* s );
+    void print( const char* s );
+    void print( char c );
+    void print( int n );
+    void print( unsigned int n );
+    void print( long n );
+    void print( unsigned long n );
+    void print( double n, int digits = 2 );
+
+    void println();
+    void println( const __FlashStringHelper* s );
+    void println( const char* s );
+    void println( char c );
+    void println( int n );
+    void println( unsigned int n );
+    void println( long n );
+    void println( unsigned long n );
+    void println( double n, int digits = 2 );
+};
+
+extern Print Serial;
+
+#include "simulation.h"
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * A stand-in for the IRremote library, for the host build.
+ * Use simulateIRCode() (in simulation.h) to "press" a button on the remote.
+ */
+
+#ifndef IRremote_h
+#define IRremote_h
+
+#include <Arduino.h>
+
+#define REPEAT 0xffffffff
+
+enum decode_type_t { UNKNOWN = -1, NEC = 1 };
+
+class decode_results
+{
+  public :
+    decode_type_t decode_type;
+    unsigned long value;
+    int bits;
+};
+
+class IRrecv
+{
+  protected :
+    int pin;
+
+  public :
+    IRrecv( int pin );
+
+    void enableIRIn();
+    int decode( decode_results* results );
+    void resume();
+};
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * A stand-in for the Arduino's SPI library, for the host build. Each byte is clocked out bit by bit on the
+ * virtual MOSI and SCK pins (and MISO is sampled), so the simulated devices (e.g. Sim74HC595) see the same edges
+ * as they would from real SPI hardware. Every byte is counted.
+ */
+
+#ifndef _SPI_H_INCLUDED
+#define _SPI_H_INCLUDED
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings
+{
+  public :
+    uint32_t clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+
+    SPISettings( uint32_t clock, uint8_t bitOrder, uint8_t dataMode );
+    SPISettings();
+};
+
+class SPIClass
+{
+  protected :
+    SPISettings settings;
+
+  public :
+    void begin();
+    void end();
+
+    void beginTransaction( SPISettings settings );
+    void endTransaction();
+
+    uint8_t transfer( uint8_t value );
+    uint16_t transfer16( uint16_t value );
+    void transfer( void* buffer, size_t count );
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * A stand-in for the Arduino's Wire library, for the host build. Transfers go to the simulated I2C devices
+ * (see SimI2CDevice in simulation.h), and every byte is counted.
+ */
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <Arduino.h>
+
+#define WIRE_BUFFER_SIZE 32
+
+class TwoWire
+{
+  protected :
+    SimI2CDevice* device; // The device being addressed, or NULL.
+    bool transmitting; // Between beginTransmission and endTransmission.
+    bool inTransaction; // Between the first start, and the stop (i.e. true after a repeated start).
+    uint8_t txAddress;
+    uint8_t txBuffer[ WIRE_BUFFER_SIZE ];
+    int txLength;
+    uint8_t rxBuffer[ WIRE_BUFFER_SIZE ];
+    int rxLength;
+    int rxIndex;
+
+  public :
+    TwoWire();
+
+    void begin();
+    void setClock( uint32_t clock );
+
+    void beginTransmission( uint8_t address );
+    void beginTransmission( int address );
+    size_t write( uint8_t value );
+    size_t write( const uint8_t* values, size_t count );
+    uint8_t endTransmission( bool sendStop = true );
+
+    uint8_t requestFrom( uint8_t address, uint8_t count, bool sendStop = true );
+    uint8_t requestFrom( int address, int count );
+    int available();
+    int read();
+
+  protected :
+    void startCondition( uint8_t address, bool reading );
+    void stopCondition();
+    void spendBytes( int count );
+};
+
+extern TwoWire Wire;
+
+#endif
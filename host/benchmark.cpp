@@ -0,0 +1,18 @@
+/*
+ * Runs the Benchmark example (examples/Benchmark) against the simulated hardware, and prints its CSV to stdout.
+ * The times are the simulated cost of the I/O only; the cost of the library's own code isn't simulated.
+ * The last column (hostNanosPerCall) is the real time per call, on this PC.
+ *
+ * Build and run using "make benchmark" (in this directory).
+ */
+
+#define BENCHMARK_MCP23017
+
+#include "../examples/Benchmark/Benchmark.ino"
+
+int main()
+{
+    new SimMCP23017( 0 ); // The MCP23017 benchmarks need a chip to talk to.
+    setup();
+    return 0;
+}
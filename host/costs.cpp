@@ -0,0 +1,281 @@
+/*
+ * Prints the simulated I/O cost of a few typical object graphs, and checks that the simulated chips ended up
+ * in the expected state. Returns the number of failed checks, so it can be used as a regression test.
+ *
+ * Build and run using "make run" (in this directory).
+ */
+
+#include <Wire.h>
+#include <SPI.h>
+#include <abstractIO.h>
+#include <abstractMCP23017.cpp.h>
+#include <abstractSPIShiftRegister.cpp.h>
+
+int failures = 0;
+
+void check( bool ok, const char* description )
+{
+    if ( ! ok ) {
+        printf( "FAILED : %s\n", description );
+        failures ++;
+    }
+}
+
+// 8 buttons on a 4051, with address pins 2, 3 and 4, and the common pin connected to pin 5.
+// The buttons pull their channel LOW when pressed, and buttons 3 and 6 are pressed.
+void muxCosts()
+{
+    Sim4051 chip( 2, 3, 4, 5 );
+    Mux* mux = (new AddressSelector( 2, 3, 4 ))->createMux( 5 );
+    for ( int i = 0; i < 8; i ++ ) {
+        chip.setChannel( i, i == 3 || i == 6 ? LOW : HIGH );
+    }
+
+    simulation.reset();
+    MuxBits bits = 0;
+    for ( int i = 0; i < 8; i ++ ) {
+        if ( mux->get( i ) ) {
+            bits |= 1 << i;
+        }
+    }
+    simulation.report( "Mux get x8" );
+    check( bits == 0x48, "Mux get" );
+
+    simulation.reset();
+    bits = mux->scanAll( 8 );
+    simulation.report( "Mux scanAll 8" );
+    check( bits == 0x48, "Mux scanAll" );
+}
+
+// 16 LEDs on two 74HC595s, using shiftOut (data 6, clock 7, latch 8), and then using SPI (latch 9).
+void shiftRegisterCosts()
+{
+    Sim74HC595 chips( 6, 7, 8, 2 );
+    BufferedShiftRegister* buffer = (new LatchedShiftRegister( 6, 7, 8 ))->buffer( 2 );
+
+    simulation.reset();
+    buffer->set( 3, true );
+    buffer->set( 12, true );
+    buffer->update();
+    simulation.report( "BufferedShiftRegister update changed" );
+    // The first byte is shifted furthest, i.e. to the second chip. MSBFIRST, so bit n is Qn.
+    check( chips.output( 8 + 3 ) && chips.output( 4 ) && chips.outputByte( 0 ) == 0x10, "BufferedShiftRegister outputs" );
+
+    simulation.reset();
+    buffer->update();
+    simulation.report( "BufferedShiftRegister update unchanged" );
+    check( chips.latches == 1, "BufferedShiftRegister unchanged doesn't latch" );
+
+    Sim74HC595 spiChips( MOSI, SCK, 9, 2 );
+    BufferedShiftRegister* spiBuffer = (new LatchedSPIShiftRegister( 9 ))->buffer( 2 );
+
+    simulation.reset();
+    spiBuffer->set( 3, true );
+    spiBuffer->set( 12, true );
+    spiBuffer->update();
+    simulation.report( "BufferedShiftRegister SPI update changed" );
+    check( spiChips.output( 8 + 3 ) && spiChips.output( 4 ) && spiChips.outputByte( 0 ) == 0x10, "SPI outputs" );
+}
+
+// Watches a chain of 74HC595s, counting the most outputs which were LOW at the same time.
+class LowWatcher : public SimDevice
+{
+  public :
+    Sim74HC595* chips;
+    uint8_t clockPin;
+    uint8_t outputs;
+    int most;
+
+    LowWatcher( uint8_t clockPin, uint8_t outputs ) : chips( NULL ), clockPin( clockPin ), outputs( outputs ), most( 0 ) {}
+
+    virtual void pinChanged( uint8_t pin, uint8_t level )
+    {
+        if ( this->chips && pin == this->clockPin && level == HIGH ) {
+            int lows = 0;
+            for ( uint8_t i = 0; i < this->outputs; i ++ ) {
+                if ( ! this->chips->output( i ) ) {
+                    lows ++;
+                }
+            }
+            if ( lows > this->most ) {
+                this->most = lows;
+            }
+        }
+    }
+};
+
+// A 74HC138 line decoder, with address pins 2, 3 and 4, driven by an AddressSelector.
+void lineDecoderCosts()
+{
+    Sim74HC138 chip( 2, 3, 4 );
+    Selector* selector = new AddressSelector( 2, 3, 4 );
+
+    simulation.reset();
+    selector->select( 5 );
+    simulation.report( "AddressSelector select 0 to 5" );
+    check( chip.selected() == 5 && chip.output( 5 ) == LOW && chip.output( 0 ) == HIGH, "74HC138 selects 5" );
+    check( simulation.counters.digitalWrites == 2, "AddressSelector only writes the changed pins" );
+
+    simulation.reset();
+    selector->select( 6 );
+    simulation.report( "AddressSelector select 5 to 6" );
+    check( chip.selected() == 6 && chip.output( 6 ) == LOW && chip.output( 5 ) == HIGH, "74HC138 selects 6" );
+
+    simulation.reset();
+    selector->select( 6 );
+    check( simulation.counters.digitalWrites == 0, "AddressSelector unchanged" );
+}
+
+// 16 buttons on two 74HC165s, using digitalRead (data 2, clock 3, load 4), and then using SPI (load 9).
+// The buttons pull their inputs LOW when pressed.
+void inputShiftRegisterCosts()
+{
+    Sim74HC165 chips( 2, 3, 4, 2 );
+    ParallelInShiftRegister* inputs = new ParallelInShiftRegister( 2, 3, 4, 2 );
+    chips.setInputByte( 0, 0x7e ); // Buttons 0 and 7 pressed
+    chips.setInputByte( 1, 0xeb ); // Buttons 10 and 12 pressed
+
+    simulation.reset();
+    inputs->read();
+    simulation.report( "ParallelInShiftRegister read 2 bytes" );
+    check( inputs->buffer[0] == 0x7e && inputs->buffer[1] == 0xeb, "ParallelInShiftRegister buffer" );
+    check( ! inputs->get( 0 ) && inputs->get( 1 ) && ! inputs->get( 7 ) && ! inputs->get( 10 ) && inputs->get( 11 ), "ParallelInShiftRegister get" );
+    check( simulation.counters.digitalReads == 16, "ParallelInShiftRegister reads each bit once" );
+
+    Input* button = inputs->createInput( 12, LOW );
+    check( button->get(), "ParallelInShiftRegister createInput" );
+
+    Sim74HC165 spiChips( MISO, SCK, 9, 2 );
+    ParallelInShiftRegister* spiInputs = new SPIParallelInShiftRegister( 9, 2 );
+    spiChips.setInputByte( 0, 0x81 );
+    spiChips.setInputByte( 1, 0x3c );
+
+    simulation.reset();
+    spiInputs->read();
+    simulation.report( "SPIParallelInShiftRegister read 2 bytes" );
+    check( spiInputs->buffer[0] == 0x81 && spiInputs->buffer[1] == 0x3c, "SPIParallelInShiftRegister buffer" );
+    check( spiInputs->get( 0 ) && ! spiInputs->get( 1 ) && spiInputs->get( 7 ) && spiInputs->get( 10 ) && ! spiInputs->get( 15 ), "SPIParallelInShiftRegister get" );
+    check( simulation.counters.spiBytes == 2 && simulation.counters.digitalReads == 0, "SPIParallelInShiftRegister uses SPI" );
+}
+
+// A ShiftRegisterSelector using wholeBytes, with two unlatched shift registers (data 6, clock 7).
+// The outputs change with every clock pulse, so the previous active (LOW) output must be cleared first.
+void unlatchedSelectorCosts()
+{
+    LowWatcher watcher( 7, 16 ); // Created before the chips, so that it sees each clock pulse after them.
+    Sim74HC595 chips( 6, 7, SIM_NO_PIN, 2 );
+    Selector* selector = new ShiftRegisterSelector( new ShiftRegister( 6, 7 ), 16, LOW, true );
+    watcher.chips = &chips;
+
+    simulation.reset();
+    selector->select( 9 );
+    simulation.report( "Unlatched ShiftRegisterSelector wholeBytes select" );
+    check( chips.outputByte( 0 ) == 0xff && chips.outputByte( 1 ) == 0xfd, "Unlatched ShiftRegisterSelector 9" );
+
+    selector->select( 3 );
+    check( chips.outputByte( 0 ) == 0xf7 && chips.outputByte( 1 ) == 0xff, "Unlatched ShiftRegisterSelector 3" );
+    check( watcher.most == 1, "Unlatched ShiftRegisterSelector only has one active output at a time" );
+}
+
+// Two unlatched shift registers, using SPI. shift() sends whole bytes using SPI, and bit-bangs the rest.
+// Then a ShiftRegisterSelector, which moves its active (LOW) output by shifting single bits.
+void spiShiftCosts()
+{
+    Sim74HC595 chips( MOSI, SCK, SIM_NO_PIN, 2 );
+    SPIShiftRegister* shiftRegister = new SPIShiftRegister();
+    byte zeros[2] = { 0, 0 };
+    shiftRegister->output( 2, zeros );
+
+    simulation.reset();
+    shiftRegister->shift( true, 3 );
+    simulation.report( "SPIShiftRegister shift 3" );
+    check( chips.outputByte( 0 ) == 0x07 && chips.outputByte( 1 ) == 0, "SPIShiftRegister shift 3" );
+
+    simulation.reset();
+    shiftRegister->shift( false, 10 );
+    simulation.report( "SPIShiftRegister shift 10" );
+    check( chips.outputByte( 0 ) == 0 && chips.outputByte( 1 ) == 0x1c, "SPIShiftRegister shift 10" );
+    check( simulation.counters.spiBytes == 1, "SPIShiftRegister shift 10 sends a whole byte using SPI" );
+
+    Selector* selector = new ShiftRegisterSelector( shiftRegister, 16 );
+    check( chips.outputByte( 0 ) == 0xfe && chips.outputByte( 1 ) == 0xff, "SPI ShiftRegisterSelector 0" );
+
+    simulation.reset();
+    selector->select( 11 );
+    simulation.report( "SPI ShiftRegisterSelector select forwards" );
+    check( chips.outputByte( 0 ) == 0xff && chips.outputByte( 1 ) == 0xf7, "SPI ShiftRegisterSelector 11" );
+
+    simulation.reset();
+    selector->select( 2 );
+    simulation.report( "SPI ShiftRegisterSelector select backwards" );
+    check( chips.outputByte( 0 ) == 0xfb && chips.outputByte( 1 ) == 0xff, "SPI ShiftRegisterSelector 2" );
+}
+
+// An MCP23017 with a button on pin 0, and an LED on pin 8, read and written once per frame.
+// Then the same again, with the chip's INTA connected to A0, so idle frames don't use the bus at all.
+void mcp23017Costs()
+{
+    // The expanders are never deleted, as i2cBus keeps a list of them.
+    SimMCP23017 chip( 0 );
+    BufferedMCP23017* expander = new BufferedMCP23017( 0 );
+
+    simulation.reset();
+    Input* button = expander->createInput( 0, LOW, true );
+    Output* led = expander->createOutput( 8 );
+    simulation.report( "MCP23017 create unbatched" );
+
+    chip.setInput( 0, LOW ); // Pressed
+    simulation.reset();
+    i2cBus.beginFrame();
+    led->set( button->get() );
+    i2cBus.endFrame();
+    simulation.report( "MCP23017 frame changed" );
+    check( chip.output( 8 ) == HIGH, "MCP23017 output" );
+
+    simulation.reset();
+    i2cBus.beginFrame();
+    led->set( button->get() );
+    i2cBus.endFrame();
+    simulation.report( "MCP23017 frame idle" );
+
+    SimMCP23017 interruptChip( 1, A0 );
+    BufferedMCP23017* interruptExpander = new BufferedMCP23017( 1 );
+
+    simulation.reset();
+    interruptExpander->beginConfiguration();
+    Input* button2 = interruptExpander->createInput( 0, LOW, true );
+    interruptExpander->createOutput( 8 );
+    interruptExpander->endConfiguration();
+    interruptExpander->useInterrupt( A0 );
+    simulation.report( "MCP23017 create batched with interrupt" );
+
+    i2cBus.beginFrame(); // Reads both chips (the interrupt pin's initial state is unknown).
+    i2cBus.endFrame();
+
+    simulation.reset();
+    i2cBus.beginFrame();
+    i2cBus.endFrame();
+    simulation.report( "MCP23017 frame idle, one chip with interrupt" );
+    check( simulation.counters.i2cTransactions == 1, "MCP23017 interrupt skips the read" );
+
+    interruptChip.setInput( 0, LOW );
+    i2cBus.beginFrame();
+    check( button2->get(), "MCP23017 interrupt input" );
+    i2cBus.endFrame();
+}
+
+int main()
+{
+    muxCosts();
+    shiftRegisterCosts();
+    lineDecoderCosts();
+    inputShiftRegisterCosts();
+    unlatchedSelectorCosts();
+    spiShiftCosts();
+    mcp23017Costs();
+
+    if ( failures ) {
+        printf( "%d check(s) failed\n", failures );
+    }
+    return failures;
+}
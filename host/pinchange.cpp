@@ -0,0 +1,132 @@
+/*
+ * Checks abstractPinChange's lists of listeners, using InterruptRotaryEncoders whose pins are in one, or two
+ * pin change groups. Returns the number of failed checks, so it can be used as a regression test.
+ *
+ * The host has no port registers or interrupts, so this pretends to be an Uno : the PINx registers are plain
+ * variables, and the PCINTx interrupt handlers are called directly, whenever a pin is changed.
+ *
+ * Build and run using "make run" (in this directory).
+ */
+
+#include <Arduino.h>
+
+// An Uno's ports : pins 0..7 are port D (PCINT2), 8..13 are port B (PCINT0) and A0..A5 are port C (PCINT1).
+volatile uint8_t simPorts[3];
+volatile uint8_t simPCICR;
+volatile uint8_t simPCMSK[3];
+uint8_t SREG;
+
+static inline byte simGroup( byte pin ) { return pin < 8 ? 2 : pin < 14 ? 0 : 1; }
+static inline byte simBit( byte pin ) { return pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14; }
+
+#define ABSTRACT_PORT_REGISTERS
+#define cli()
+#define digitalPinToPCICR( pin ) ( (pin) < 20 ? &simPCICR : (volatile uint8_t*) 0 )
+#define digitalPinToPCICRbit( pin ) simGroup( pin )
+#define digitalPinToPCMSK( pin ) ( &simPCMSK[ simGroup( pin ) ] )
+#define digitalPinToPCMSKbit( pin ) simBit( pin )
+#define digitalPinToPort( pin ) simGroup( pin )
+#define digitalPinToBitMask( pin ) ( 1 << simBit( pin ) )
+#define portInputRegister( port ) ( &simPorts[ port ] )
+
+#define ISR( vector ) void vector()
+#define PCINT0_vect simPCINT0
+#define PCINT1_vect simPCINT1
+#define PCINT2_vect simPCINT2
+
+#include <abstractIO.h>
+#include <abstractPinChange.cpp.h>
+
+int failures = 0;
+
+void check( bool ok, const char* description )
+{
+    if ( ! ok ) {
+        printf( "FAILED : %s\n", description );
+        failures ++;
+    }
+}
+
+// Changes a pin, and calls its group's interrupt handler (if its pin change interrupt is enabled).
+void setPin( byte pin, bool value )
+{
+    byte group = simGroup( pin );
+    if ( value ) {
+        simPorts[ group ] |= 1 << simBit( pin );
+    } else {
+        simPorts[ group ] &= ~(1 << simBit( pin ));
+    }
+    if ( (simPCICR & (1 << group)) && (simPCMSK[ group ] & (1 << simBit( pin ))) ) {
+        if ( group == 0 ) simPCINT0();
+        if ( group == 1 ) simPCINT1();
+        if ( group == 2 ) simPCINT2();
+    }
+}
+
+bool getPin( byte pin )
+{
+    return simPorts[ simGroup( pin ) ] & (1 << simBit( pin ));
+}
+
+// Turns an encoder by one detent (4 transitions) in either direction.
+void turn( byte pinA, byte pinB, bool clockwise )
+{
+    for ( int i = 0; i < 4; i ++ ) {
+        // Quadrature : clockwise, B changes when A == B, and A changes when they differ.
+        bool changeB = ( getPin( pinA ) == getPin( pinB ) ) == clockwise;
+        if ( changeB ) {
+            setPin( pinB, ! getPin( pinB ) );
+        } else {
+            setPin( pinA, ! getPin( pinA ) );
+        }
+    }
+}
+
+// The number of listeners in a group's list (stopping at 10, in case the list has become a loop).
+int listenerCount( byte group )
+{
+    int count = 0;
+    for ( PinChangeListener* listener = abstractPinChangeListeners[ group ]; listener != NULL && count < 10; listener = listener->nextPinChangeListener ) {
+        count ++;
+    }
+    return count;
+}
+
+int main()
+{
+    simPorts[ 0 ] = simPorts[ 1 ] = simPorts[ 2 ] = 0xff; // Pulled up.
+
+    // Encoder 1 is only in group 2, encoder 2 spans groups 2 and 0, and encoder 3 is only in group 0.
+    InterruptRotaryEncoder encoder1( 2, 3 );
+    InterruptRotaryEncoder encoder2( 4, 8 );
+    InterruptRotaryEncoder encoder3( 9, 10 );
+
+    check( listenerCount( 2 ) == 2, "Group 2 has encoders 1 and 2" );
+    check( listenerCount( 0 ) == 2, "Group 0 has encoders 2 and 3" );
+    check( listenerCount( 1 ) == 0, "Group 1 is empty" );
+    check( simPCICR == 0x05, "PCICR" );
+    check( simPCMSK[ 2 ] == 0x1c && simPCMSK[ 0 ] == 0x07, "PCMSK" );
+
+    turn( 2, 3, true );
+    turn( 2, 3, true );
+    turn( 4, 8, true );
+    turn( 4, 8, true );
+    turn( 4, 8, true );
+    turn( 9, 10, false );
+    check( encoder1.get() == 2, "Encoder 1" );
+    check( encoder2.get() == 3, "Encoder 2, spanning two groups" );
+    check( encoder3.get() == -1, "Encoder 3" );
+
+    turn( 4, 8, false );
+    turn( 2, 3, false );
+    check( encoder1.get() == 1 && encoder2.get() == 2 && encoder3.get() == -1, "Turning back" );
+
+    // A listener can't be attached to a second group (it would corrupt the first group's list).
+    check( ! attachPinChange( 15, &encoder1 ), "Attaching a listener to a second group" );
+    check( listenerCount( 1 ) == 0 && listenerCount( 2 ) == 2, "Lists after the rejected attach" );
+
+    printf( "pinchange : %d failures\n", failures );
+    return failures;
+}
+
+// END
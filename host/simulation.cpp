@@ -0,0 +1,1046 @@
+/*
+ * The simulated hardware, and the mock Arduino core, Wire, SPI and IRremote. See simulation.h
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <IRremote.h>
+
+#include <stdio.h>
+#include <chrono>
+
+Simulation simulation;
+
+// SIM COSTS
+
+SimCosts::SimCosts()
+{
+    this->pinMode = 70;
+    this->digitalRead = 60;
+    this->digitalWrite = 70;
+    this->analogRead = 1700;
+    this->analogWrite = 100;
+    this->shiftOut = 1700;
+    this->shiftIn = 1700;
+    this->i2cTransaction = 400;
+    this->i2cByte = 50;
+    this->spiByte = 30;
+}
+
+// SIM COUNTERS
+
+SimCounters::SimCounters()
+{
+    this->clear();
+}
+
+void SimCounters::clear()
+{
+    this->pinModes = 0;
+    this->digitalReads = 0;
+    this->digitalWrites = 0;
+    this->analogReads = 0;
+    this->analogWrites = 0;
+    this->shiftOuts = 0;
+    this->shiftIns = 0;
+    this->i2cBytes = 0;
+    this->i2cTransactions = 0;
+    this->spiBytes = 0;
+    this->cycles = 0;
+}
+
+// SIM DEVICE
+
+SimDevice::SimDevice()
+{
+    simulation.add( this );
+}
+
+SimDevice::~SimDevice()
+{
+    simulation.remove( this );
+}
+
+void SimDevice::pinChanged( uint8_t pin, uint8_t level )
+{
+}
+
+bool SimDevice::drivesPin( uint8_t pin, uint8_t* level )
+{
+    return false;
+}
+
+bool SimDevice::drivesAnalog( uint8_t pin, int* value )
+{
+    return false;
+}
+
+// SIM I2C DEVICE
+
+SimI2CDevice::SimI2CDevice( uint8_t address )
+{
+    this->address = address;
+}
+
+void SimI2CDevice::start( bool reading )
+{
+}
+
+void SimI2CDevice::write( uint8_t value )
+{
+}
+
+uint8_t SimI2CDevice::read()
+{
+    return 0xff;
+}
+
+void SimI2CDevice::stop()
+{
+}
+
+// SIMULATION
+
+Simulation::Simulation()
+{
+    this->devices = NULL;
+    this->time = 0;
+    this->i2cClock = 100000;
+    this->spiClock = 4000000;
+    for ( int i = 0; i < SIM_PINS; i ++ ) {
+        this->modes[i] = INPUT;
+        this->outputs[i] = LOW;
+        this->inputs[i] = LOW;
+        this->inputSet[i] = false;
+        this->analogs[i] = 0;
+    }
+}
+
+void Simulation::reset()
+{
+    this->counters.clear();
+}
+
+void Simulation::advance( unsigned long micros )
+{
+    this->time += (uint64_t) micros * (F_CPU / 1000000);
+}
+
+uint64_t Simulation::cycles()
+{
+    return this->time;
+}
+
+unsigned long Simulation::micros()
+{
+    return (unsigned long) (this->time / (F_CPU / 1000000));
+}
+
+uint64_t Simulation::hostNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+void Simulation::setPin( uint8_t pin, uint8_t level )
+{
+    if ( pin < SIM_PINS ) {
+        this->inputs[ pin ] = level ? HIGH : LOW;
+        this->inputSet[ pin ] = true;
+        this->analogs[ pin ] = level ? 1023 : 0;
+    }
+}
+
+void Simulation::setAnalog( uint8_t pin, int value )
+{
+    if ( pin < SIM_PINS ) {
+        this->analogs[ pin ] = value;
+        this->inputs[ pin ] = value >= 512 ? HIGH : LOW;
+        this->inputSet[ pin ] = true;
+    }
+}
+
+uint8_t Simulation::pin( uint8_t pin )
+{
+    return pin < SIM_PINS ? this->outputs[ pin ] : LOW;
+}
+
+uint8_t Simulation::mode( uint8_t pin )
+{
+    return pin < SIM_PINS ? this->modes[ pin ] : INPUT;
+}
+
+void Simulation::report( const char* label, FILE* out )
+{
+    fprintf( out, "%s : pinMode %lu digitalRead %lu digitalWrite %lu analogRead %lu analogWrite %lu shiftOut %lu shiftIn %lu "
+        "i2cBytes %lu i2cTransactions %lu spiBytes %lu cycles %llu micros %.1f\n",
+        label, this->counters.pinModes, this->counters.digitalReads, this->counters.digitalWrites,
+        this->counters.analogReads, this->counters.analogWrites, this->counters.shiftOuts, this->counters.shiftIns,
+        this->counters.i2cBytes, this->counters.i2cTransactions, this->counters.spiBytes,
+        (unsigned long long) this->counters.cycles, this->counters.cycles / (F_CPU / 1000000.0) );
+}
+
+void Simulation::add( SimDevice* device )
+{
+    device->nextDevice = this->devices;
+    this->devices = device;
+}
+
+void Simulation::remove( SimDevice* device )
+{
+    for ( SimDevice** p = &this->devices; *p; p = &(*p)->nextDevice ) {
+        if ( *p == device ) {
+            *p = device->nextDevice;
+            return;
+        }
+    }
+}
+
+SimI2CDevice* Simulation::findI2C( uint8_t address )
+{
+    for ( SimDevice* device = this->devices; device; device = device->nextDevice ) {
+        SimI2CDevice* i2c = dynamic_cast<SimI2CDevice*>( device );
+        if ( i2c && i2c->address == address ) {
+            return i2c;
+        }
+    }
+    return NULL;
+}
+
+void Simulation::spend( uint64_t cycles )
+{
+    this->time += cycles;
+    this->counters.cycles += cycles;
+}
+
+void Simulation::setMode( uint8_t pin, uint8_t mode )
+{
+    if ( pin < SIM_PINS ) {
+        this->modes[ pin ] = mode;
+        // As on an AVR, the output latch doubles as the pullup enable.
+        if ( mode == INPUT_PULLUP ) {
+            this->write( pin, HIGH );
+        } else if ( mode == INPUT ) {
+            this->write( pin, LOW );
+        }
+    }
+}
+
+void Simulation::write( uint8_t pin, uint8_t level )
+{
+    level = level ? HIGH : LOW;
+    if ( pin < SIM_PINS && this->outputs[ pin ] != level ) {
+        this->outputs[ pin ] = level;
+        for ( SimDevice* device = this->devices; device; device = device->nextDevice ) {
+            device->pinChanged( pin, level );
+        }
+    }
+}
+
+uint8_t Simulation::read( uint8_t pin )
+{
+    if ( pin >= SIM_PINS ) {
+        return LOW;
+    }
+    uint8_t level;
+    for ( SimDevice* device = this->devices; device; device = device->nextDevice ) {
+        if ( device->drivesPin( pin, &level ) ) {
+            return level ? HIGH : LOW;
+        }
+    }
+    if ( this->modes[ pin ] != OUTPUT && this->inputSet[ pin ] ) {
+        return this->inputs[ pin ];
+    }
+    return this->outputs[ pin ]; // An output, or an unconnected input (HIGH if pulled up).
+}
+
+int Simulation::readAnalog( uint8_t pin )
+{
+    if ( pin >= SIM_PINS ) {
+        return 0;
+    }
+    int value;
+    for ( SimDevice* device = this->devices; device; device = device->nextDevice ) {
+        if ( device->drivesAnalog( pin, &value ) ) {
+            return value;
+        }
+    }
+    return this->analogs[ pin ];
+}
+
+// SIM 74HC595
+
+Sim74HC595::Sim74HC595( uint8_t dataPin, uint8_t clockPin, uint8_t latchPin, uint8_t chips )
+{
+    this->dataPin = dataPin;
+    this->clockPin = clockPin;
+    this->latchPin = latchPin;
+    this->chips = chips;
+    this->shifted = new uint8_t[ chips ]();
+    this->latched = new uint8_t[ chips ]();
+    this->clocks = 0;
+    this->latches = 0;
+}
+
+Sim74HC595::~Sim74HC595()
+{
+    delete [] this->shifted;
+    delete [] this->latched;
+}
+
+uint8_t Sim74HC595::output( uint8_t index )
+{
+    return (this->outputByte( index >> 3 ) >> (index & 7)) & 1;
+}
+
+uint8_t Sim74HC595::outputByte( uint8_t chip )
+{
+    if ( chip >= this->chips ) {
+        return 0;
+    }
+    return this->latchPin == SIM_NO_PIN ? this->shifted[ chip ] : this->latched[ chip ];
+}
+
+void Sim74HC595::pinChanged( uint8_t pin, uint8_t level )
+{
+    if ( pin == this->clockPin && level == HIGH ) {
+        // QH of each chip feeds the serial input of the next.
+        for ( int i = this->chips - 1; i > 0; i -- ) {
+            this->shifted[i] = (this->shifted[i] << 1) | (this->shifted[i-1] >> 7);
+        }
+        this->shifted[0] = (this->shifted[0] << 1) | simulation.pin( this->dataPin );
+        this->clocks ++;
+    }
+    if ( pin == this->latchPin && level == HIGH ) {
+        memcpy( this->latched, this->shifted, this->chips );
+        this->latches ++;
+    }
+}
+
+// SIM 74HC165
+
+Sim74HC165::Sim74HC165( uint8_t dataPin, uint8_t clockPin, uint8_t loadPin, uint8_t chips )
+{
+    this->dataPin = dataPin;
+    this->clockPin = clockPin;
+    this->loadPin = loadPin;
+    this->chips = chips;
+    this->inputs = new uint8_t[ chips ]();
+    this->shifted = new uint8_t[ chips ]();
+}
+
+Sim74HC165::~Sim74HC165()
+{
+    delete [] this->inputs;
+    delete [] this->shifted;
+}
+
+void Sim74HC165::setInput( uint8_t index, uint8_t level )
+{
+    if ( (index >> 3) < this->chips ) {
+        uint8_t mask = 1 << (index & 7);
+        this->setInputByte( index >> 3, level ? this->inputs[ index >> 3 ] | mask : this->inputs[ index >> 3 ] & ~mask );
+    }
+}
+
+void Sim74HC165::setInputByte( uint8_t chip, uint8_t value )
+{
+    if ( chip < this->chips ) {
+        this->inputs[ chip ] = value;
+        if ( simulation.pin( this->loadPin ) == LOW ) {
+            this->shifted[ chip ] = value; // The parallel load is transparent while the load pin is LOW.
+        }
+    }
+}
+
+void Sim74HC165::pinChanged( uint8_t pin, uint8_t level )
+{
+    if ( pin == this->loadPin && level == LOW ) {
+        memcpy( this->shifted, this->inputs, this->chips );
+    }
+    if ( pin == this->clockPin && level == HIGH && simulation.pin( this->loadPin ) == HIGH ) {
+        // The QH of each chip feeds the serial input of the previous one. The last chip's serial input is LOW.
+        for ( int i = 0; i < this->chips; i ++ ) {
+            uint8_t next = i + 1 < this->chips ? this->shifted[ i + 1 ] >> 7 : 0;
+            this->shifted[i] = (this->shifted[i] << 1) | next;
+        }
+    }
+}
+
+bool Sim74HC165::drivesPin( uint8_t pin, uint8_t* level )
+{
+    if ( pin == this->dataPin ) {
+        *level = this->shifted[0] >> 7;
+        return true;
+    }
+    return false;
+}
+
+// SIM 4051
+
+Sim4051::Sim4051( uint8_t s0, uint8_t s1, uint8_t s2, uint8_t commonPin, uint8_t inhibitPin )
+{
+    this->addressPins[0] = s0;
+    this->addressPins[1] = s1;
+    this->addressPins[2] = s2;
+    this->commonPin = commonPin;
+    this->inhibitPin = inhibitPin;
+    for ( int i = 0; i < 8; i ++ ) {
+        this->values[i] = 0;
+    }
+    this->switches = 0;
+    this->previous = 0;
+}
+
+void Sim4051::setChannel( uint8_t channel, uint8_t level )
+{
+    this->setAnalog( channel, level ? 1023 : 0 );
+}
+
+void Sim4051::setAnalog( uint8_t channel, int value )
+{
+    if ( channel < 8 ) {
+        this->values[ channel ] = value;
+    }
+}
+
+uint8_t Sim4051::selected()
+{
+    uint8_t channel = 0;
+    for ( int i = 0; i < 3; i ++ ) {
+        channel |= simulation.pin( this->addressPins[i] ) << i;
+    }
+    return channel;
+}
+
+void Sim4051::pinChanged( uint8_t pin, uint8_t level )
+{
+    uint8_t channel = this->selected();
+    if ( channel != this->previous ) {
+        this->previous = channel;
+        this->switches ++;
+    }
+}
+
+bool Sim4051::drivesPin( uint8_t pin, uint8_t* level )
+{
+    int value;
+    if ( this->drivesAnalog( pin, &value ) ) {
+        *level = value >= 512 ? HIGH : LOW;
+        return true;
+    }
+    return false;
+}
+
+bool Sim4051::drivesAnalog( uint8_t pin, int* value )
+{
+    if ( pin != this->commonPin ) {
+        return false;
+    }
+    if ( this->inhibitPin != SIM_NO_PIN && simulation.pin( this->inhibitPin ) == HIGH ) {
+        return false; // All channels are disconnected.
+    }
+    *value = this->values[ this->selected() ];
+    return true;
+}
+
+// SIM 74HC138
+
+Sim74HC138::Sim74HC138( uint8_t a0, uint8_t a1, uint8_t a2, uint8_t enablePin )
+{
+    this->addressPins[0] = a0;
+    this->addressPins[1] = a1;
+    this->addressPins[2] = a2;
+    this->enablePin = enablePin;
+    this->changes = 0;
+    this->previous = this->selected();
+}
+
+int Sim74HC138::selected()
+{
+    if ( this->enablePin != SIM_NO_PIN && simulation.pin( this->enablePin ) == HIGH ) {
+        return -1;
+    }
+    int address = 0;
+    for ( int i = 0; i < 3; i ++ ) {
+        address |= simulation.pin( this->addressPins[i] ) << i;
+    }
+    return address;
+}
+
+uint8_t Sim74HC138::output( uint8_t index )
+{
+    return this->selected() == index ? LOW : HIGH;
+}
+
+void Sim74HC138::pinChanged( uint8_t pin, uint8_t level )
+{
+    int current = this->selected();
+    if ( current != this->previous ) {
+        this->previous = current;
+        this->changes ++;
+    }
+}
+
+// SIM MCP23017
+
+#define SIM_MCP23017_IODIR 0x00
+#define SIM_MCP23017_IPOL 0x02
+#define SIM_MCP23017_GPINTEN 0x04
+#define SIM_MCP23017_DEFVAL 0x06
+#define SIM_MCP23017_INTCON 0x08
+#define SIM_MCP23017_IOCON 0x0A
+#define SIM_MCP23017_GPPU 0x0C
+#define SIM_MCP23017_INTF 0x0E
+#define SIM_MCP23017_INTCAP 0x10
+#define SIM_MCP23017_GPIO 0x12
+#define SIM_MCP23017_OLAT 0x14
+
+#define SIM_MCP23017_MIRROR 0x40
+#define SIM_MCP23017_SEQOP 0x20
+#define SIM_MCP23017_ODR 0x04
+#define SIM_MCP23017_INTPOL 0x02
+
+SimMCP23017::SimMCP23017( uint8_t address, uint8_t interruptPin ) : SimI2CDevice( 0x20 | address )
+{
+    memset( this->registers, 0, sizeof( this->registers ) );
+    this->registers[ SIM_MCP23017_IODIR ] = 0xff;
+    this->registers[ SIM_MCP23017_IODIR + 1 ] = 0xff;
+    this->pins = 0;
+    this->connected = 0;
+    this->pointer = 0;
+    this->addressed = false;
+    this->interruptPin = interruptPin;
+}
+
+uint16_t SimMCP23017::get( uint8_t registerID )
+{
+    return (this->registers[ registerID + 1 ] << 8) | this->registers[ registerID ];
+}
+
+void SimMCP23017::set( uint8_t registerID, uint16_t value )
+{
+    this->registers[ registerID ] = value & 0xff;
+    this->registers[ registerID + 1 ] = value >> 8;
+}
+
+uint16_t SimMCP23017::iodir()
+{
+    return this->get( SIM_MCP23017_IODIR );
+}
+
+uint16_t SimMCP23017::olat()
+{
+    return this->get( SIM_MCP23017_OLAT );
+}
+
+uint16_t SimMCP23017::levels()
+{
+    uint16_t inputs = this->iodir();
+    // Unconnected inputs float (LOW), unless pulled up.
+    uint16_t external = (this->pins & this->connected) | (this->get( SIM_MCP23017_GPPU ) & ~this->connected);
+    return (this->olat() & ~inputs) | (external & inputs);
+}
+
+uint8_t SimMCP23017::output( uint8_t pin )
+{
+    return (this->levels() >> pin) & 1;
+}
+
+void SimMCP23017::setInput( uint8_t pin, uint8_t level )
+{
+    uint16_t before = this->levels();
+    uint16_t mask = 1 << pin;
+    this->connected |= mask;
+    this->pins = level ? this->pins | mask : this->pins & ~mask;
+    uint16_t after = this->levels();
+
+    // Interrupt-on-change. INTCON selects comparing against DEFVAL, or against the previous value.
+    uint16_t intcon = this->get( SIM_MCP23017_INTCON );
+    uint16_t triggered = ((after ^ this->get( SIM_MCP23017_DEFVAL )) & intcon) | ((after ^ before) & ~intcon);
+    triggered &= this->get( SIM_MCP23017_GPINTEN ) & this->iodir();
+    if ( triggered ) {
+        uint16_t intf = this->get( SIM_MCP23017_INTF );
+        uint16_t captured = after ^ this->get( SIM_MCP23017_IPOL );
+        // INTCAP is only captured by the first interrupt on each port (until it is cleared).
+        if ( (triggered & 0x00ff) && ! (intf & 0x00ff) ) {
+            this->registers[ SIM_MCP23017_INTCAP ] = captured & 0xff;
+        }
+        if ( (triggered & 0xff00) && ! (intf & 0xff00) ) {
+            this->registers[ SIM_MCP23017_INTCAP + 1 ] = captured >> 8;
+        }
+        this->set( SIM_MCP23017_INTF, intf | triggered );
+    }
+}
+
+void SimMCP23017::start( bool reading )
+{
+    this->addressed = reading; // When reading, the register address is left over from the previous write.
+}
+
+void SimMCP23017::write( uint8_t value )
+{
+    if ( ! this->addressed ) {
+        this->pointer = value;
+        this->addressed = true;
+        return;
+    }
+    uint8_t r = this->pointer;
+    if ( r < sizeof( this->registers ) && r != SIM_MCP23017_INTF && r != SIM_MCP23017_INTF + 1 &&
+        r != SIM_MCP23017_INTCAP && r != SIM_MCP23017_INTCAP + 1 ) {
+
+        if ( r == SIM_MCP23017_GPIO || r == SIM_MCP23017_GPIO + 1 ) {
+            r += SIM_MCP23017_OLAT - SIM_MCP23017_GPIO; // Writing to GPIO writes to OLAT.
+        }
+        this->registers[ r ] = value;
+        if ( r == SIM_MCP23017_IOCON || r == SIM_MCP23017_IOCON + 1 ) {
+            // IOCONA and IOCONB are the same register.
+            this->registers[ SIM_MCP23017_IOCON ] = value;
+            this->registers[ SIM_MCP23017_IOCON + 1 ] = value;
+        }
+    }
+    if ( ! (this->registers[ SIM_MCP23017_IOCON ] & SIM_MCP23017_SEQOP) ) {
+        this->pointer = (this->pointer + 1) % sizeof( this->registers );
+    }
+}
+
+uint8_t SimMCP23017::read()
+{
+    uint8_t r = this->pointer;
+    uint8_t value = 0;
+    if ( r == SIM_MCP23017_GPIO || r == SIM_MCP23017_GPIO + 1 ) {
+        value = (this->levels() ^ this->get( SIM_MCP23017_IPOL )) >> ((r & 1) * 8);
+    } else if ( r < sizeof( this->registers ) ) {
+        value = this->registers[ r ];
+    }
+
+    // Reading GPIO or INTCAP clears the port's interrupt.
+    if ( r == SIM_MCP23017_GPIO || r == SIM_MCP23017_INTCAP ) {
+        this->registers[ SIM_MCP23017_INTF ] = 0;
+    } else if ( r == SIM_MCP23017_GPIO + 1 || r == SIM_MCP23017_INTCAP + 1 ) {
+        this->registers[ SIM_MCP23017_INTF + 1 ] = 0;
+    }
+
+    if ( ! (this->registers[ SIM_MCP23017_IOCON ] & SIM_MCP23017_SEQOP) ) {
+        this->pointer = (this->pointer + 1) % sizeof( this->registers );
+    }
+    return value;
+}
+
+bool SimMCP23017::drivesPin( uint8_t pin, uint8_t* level )
+{
+    if ( pin != this->interruptPin || pin == SIM_NO_PIN ) {
+        return false;
+    }
+    uint8_t iocon = this->registers[ SIM_MCP23017_IOCON ];
+    uint16_t intf = this->get( SIM_MCP23017_INTF );
+    // interruptPin is connected to INTA, which (with MIRROR) is triggered by either bank.
+    bool active = (iocon & SIM_MCP23017_MIRROR) ? intf != 0 : (intf & 0xff) != 0;
+    if ( iocon & SIM_MCP23017_ODR ) {
+        if ( ! active ) {
+            return false; // Open drain, so the pin is only ever pulled LOW.
+        }
+        *level = LOW;
+    } else {
+        bool activeHigh = (iocon & SIM_MCP23017_INTPOL) != 0;
+        *level = active == activeHigh ? HIGH : LOW;
+    }
+    return true;
+}
+
+// ARDUINO
+
+void pinMode( uint8_t pin, uint8_t mode )
+{
+    simulation.counters.pinModes ++;
+    simulation.spend( simulation.costs.pinMode );
+    simulation.setMode( pin, mode );
+}
+
+void digitalWrite( uint8_t pin, uint8_t value )
+{
+    simulation.counters.digitalWrites ++;
+    simulation.spend( simulation.costs.digitalWrite );
+    simulation.write( pin, value );
+}
+
+int digitalRead( uint8_t pin )
+{
+    simulation.counters.digitalReads ++;
+    simulation.spend( simulation.costs.digitalRead );
+    return simulation.read( pin );
+}
+
+int analogRead( uint8_t pin )
+{
+    if ( pin < A0 ) {
+        pin += A0; // Channel numbers, as well as pin numbers, are allowed.
+    }
+    simulation.counters.analogReads ++;
+    simulation.spend( simulation.costs.analogRead );
+    return simulation.readAnalog( pin );
+}
+
+void analogWrite( uint8_t pin, int value )
+{
+    simulation.counters.analogWrites ++;
+    simulation.spend( simulation.costs.analogWrite );
+    simulation.setMode( pin, OUTPUT );
+    simulation.write( pin, value >= 128 ? HIGH : LOW );
+}
+
+void shiftOut( uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t value )
+{
+    simulation.counters.shiftOuts ++;
+    simulation.spend( simulation.costs.shiftOut );
+    for ( int i = 0; i < 8; i ++ ) {
+        simulation.write( dataPin, bitOrder == LSBFIRST ? (value >> i) & 1 : (value >> (7 - i)) & 1 );
+        simulation.write( clockPin, HIGH );
+        simulation.write( clockPin, LOW );
+    }
+}
+
+uint8_t shiftIn( uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder )
+{
+    simulation.counters.shiftIns ++;
+    simulation.spend( simulation.costs.shiftIn );
+    uint8_t value = 0;
+    for ( int i = 0; i < 8; i ++ ) {
+        // The same as the Arduino's shiftIn, which reads after the rising edge.
+        simulation.write( clockPin, HIGH );
+        if ( bitOrder == LSBFIRST ) {
+            value |= simulation.read( dataPin ) << i;
+        } else {
+            value |= simulation.read( dataPin ) << (7 - i);
+        }
+        simulation.write( clockPin, LOW );
+    }
+    return value;
+}
+
+unsigned long millis()
+{
+    return simulation.micros() / 1000;
+}
+
+unsigned long micros()
+{
+    return simulation.micros();
+}
+
+void delay( unsigned long ms )
+{
+    simulation.advance( ms * 1000 );
+}
+
+void delayMicroseconds( unsigned int us )
+{
+    simulation.advance( us );
+}
+
+void noInterrupts()
+{
+}
+
+void interrupts()
+{
+}
+
+long map( long x, long inMin, long inMax, long outMin, long outMax )
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+long random( long max )
+{
+    return max <= 0 ? 0 : rand() % max;
+}
+
+long random( long min, long max )
+{
+    return min >= max ? min : min + random( max - min );
+}
+
+void randomSeed( unsigned long seed )
+{
+    srand( seed );
+}
+
+// SERIAL
+
+Print Serial;
+
+void Print::begin( unsigned long baud ) { }
+
+void Print::print( const __FlashStringHelper* s ) { fputs( (const char*) s, stdout ); }
+void Print::print( const char* s ) { fputs( s, stdout ); }
+void Print::print( char c ) { putchar( c ); }
+void Print::print( int n ) { printf( "%d", n ); }
+void Print::print( unsigned int n ) { printf( "%u", n ); }
+void Print::print( long n ) { printf( "%ld", n ); }
+void Print::print( unsigned long n ) { printf( "%lu", n ); }
+void Print::print( double n, int digits ) { printf( "%.*f", digits, n ); }
+
+void Print::println() { putchar( '\n' ); }
+void Print::println( const __FlashStringHelper* s ) { this->print( s ); this->println(); }
+void Print::println( const char* s ) { this->print( s ); this->println(); }
+void Print::println( char c ) { this->print( c ); this->println(); }
+void Print::println( int n ) { this->print( n ); this->println(); }
+void Print::println( unsigned int n ) { this->print( n ); this->println(); }
+void Print::println( long n ) { this->print( n ); this->println(); }
+void Print::println( unsigned long n ) { this->print( n ); this->println(); }
+void Print::println( double n, int digits ) { this->print( n, digits ); this->println(); }
+
+// WIRE
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+{
+    this->device = NULL;
+    this->transmitting = false;
+    this->inTransaction = false;
+    this->txLength = 0;
+    this->rxLength = 0;
+    this->rxIndex = 0;
+}
+
+void TwoWire::begin()
+{
+}
+
+void TwoWire::setClock( uint32_t clock )
+{
+    simulation.i2cClock = clock;
+}
+
+void TwoWire::spendBytes( int count )
+{
+    simulation.counters.i2cBytes += count;
+    simulation.spend( (uint64_t) count * (9 * F_CPU / simulation.i2cClock + simulation.costs.i2cByte) );
+}
+
+void TwoWire::startCondition( uint8_t address, bool reading )
+{
+    if ( ! this->inTransaction ) {
+        this->inTransaction = true;
+        simulation.counters.i2cTransactions ++;
+        simulation.spend( 2 * F_CPU / simulation.i2cClock + simulation.costs.i2cTransaction ); // The start and stop.
+    }
+    this->device = simulation.findI2C( address );
+    if ( this->device ) {
+        this->device->start( reading );
+    }
+    this->spendBytes( 1 ); // The address byte.
+}
+
+void TwoWire::stopCondition()
+{
+    if ( this->device ) {
+        this->device->stop();
+    }
+    this->device = NULL;
+    this->inTransaction = false;
+}
+
+void TwoWire::beginTransmission( uint8_t address )
+{
+    this->txAddress = address;
+    this->txLength = 0;
+    this->transmitting = true;
+}
+
+void TwoWire::beginTransmission( int address )
+{
+    this->beginTransmission( (uint8_t) address );
+}
+
+size_t TwoWire::write( uint8_t value )
+{
+    if ( ! this->transmitting || this->txLength >= WIRE_BUFFER_SIZE ) {
+        return 0;
+    }
+    this->txBuffer[ this->txLength ++ ] = value;
+    return 1;
+}
+
+size_t TwoWire::write( const uint8_t* values, size_t count )
+{
+    for ( size_t i = 0; i < count; i ++ ) {
+        if ( ! this->write( values[i] ) ) {
+            return i;
+        }
+    }
+    return count;
+}
+
+uint8_t TwoWire::endTransmission( bool sendStop )
+{
+    this->transmitting = false;
+    this->startCondition( this->txAddress, false );
+    uint8_t result = this->device ? 0 : 2; // 2 : The address was not acknowledged.
+    if ( this->device ) {
+        for ( int i = 0; i < this->txLength; i ++ ) {
+            this->device->write( this->txBuffer[i] );
+        }
+        this->spendBytes( this->txLength );
+    }
+    if ( sendStop || ! this->device ) {
+        this->stopCondition();
+    }
+    return result;
+}
+
+uint8_t TwoWire::requestFrom( uint8_t address, uint8_t count, bool sendStop )
+{
+    if ( count > WIRE_BUFFER_SIZE ) {
+        count = WIRE_BUFFER_SIZE;
+    }
+    this->startCondition( address, true );
+    this->rxIndex = 0;
+    this->rxLength = 0;
+    if ( this->device ) {
+        for ( int i = 0; i < count; i ++ ) {
+            this->rxBuffer[ i ] = this->device->read();
+        }
+        this->rxLength = count;
+        this->spendBytes( count );
+    }
+    if ( sendStop || ! this->device ) {
+        this->stopCondition();
+    }
+    return this->rxLength;
+}
+
+uint8_t TwoWire::requestFrom( int address, int count )
+{
+    return this->requestFrom( (uint8_t) address, (uint8_t) count, true );
+}
+
+int TwoWire::available()
+{
+    return this->rxLength - this->rxIndex;
+}
+
+int TwoWire::read()
+{
+    return this->rxIndex < this->rxLength ? this->rxBuffer[ this->rxIndex ++ ] : -1;
+}
+
+// SPI
+
+SPIClass SPI;
+
+SPISettings::SPISettings( uint32_t clock, uint8_t bitOrder, uint8_t dataMode )
+{
+    this->clock = clock;
+    this->bitOrder = bitOrder;
+    this->dataMode = dataMode;
+}
+
+SPISettings::SPISettings()
+{
+    this->clock = 4000000;
+    this->bitOrder = MSBFIRST;
+    this->dataMode = SPI_MODE0;
+}
+
+void SPIClass::begin()
+{
+    simulation.setMode( SCK, OUTPUT );
+    simulation.setMode( MOSI, OUTPUT );
+    simulation.setMode( SS, OUTPUT );
+}
+
+void SPIClass::end()
+{
+}
+
+void SPIClass::beginTransaction( SPISettings settings )
+{
+    this->settings = settings;
+    simulation.spiClock = settings.clock;
+}
+
+void SPIClass::endTransaction()
+{
+}
+
+uint8_t SPIClass::transfer( uint8_t value )
+{
+    // The clock is at most half of the CPU's clock.
+    uint32_t clock = this->settings.clock < F_CPU / 2 ? this->settings.clock : F_CPU / 2;
+    simulation.counters.spiBytes ++;
+    simulation.spend( 8 * F_CPU / clock + simulation.costs.spiByte );
+
+    // SPI_MODE0 : The data is sampled on the rising edge of the clock. (The other modes are treated the same).
+    uint8_t result = 0;
+    for ( int i = 0; i < 8; i ++ ) {
+        int bit = this->settings.bitOrder == LSBFIRST ? i : 7 - i;
+        simulation.write( MOSI, (value >> bit) & 1 );
+        result |= simulation.read( MISO ) << bit;
+        simulation.write( SCK, HIGH );
+        simulation.write( SCK, LOW );
+    }
+    return result;
+}
+
+uint16_t SPIClass::transfer16( uint16_t value )
+{
+    if ( this->settings.bitOrder == LSBFIRST ) {
+        uint8_t low = this->transfer( value & 0xff );
+        return low | (this->transfer( value >> 8 ) << 8);
+    } else {
+        uint8_t high = this->transfer( value >> 8 );
+        return (high << 8) | this->transfer( value & 0xff );
+    }
+}
+
+void SPIClass::transfer( void* buffer, size_t count )
+{
+    uint8_t* bytes = (uint8_t*) buffer;
+    for ( size_t i = 0; i < count; i ++ ) {
+        bytes[i] = this->transfer( bytes[i] );
+    }
+}
+
+// IR REMOTE
+
+#define SIM_IR_CODES 16
+
+static unsigned long simIRCodes[ SIM_IR_CODES ];
+static uint8_t simIRHead = 0;
+static uint8_t simIRTail = 0;
+
+void simulateIRCode( unsigned long value )
+{
+    if ( (uint8_t) (simIRHead - simIRTail) < SIM_IR_CODES ) {
+        simIRCodes[ simIRHead ++ % SIM_IR_CODES ] = value;
+    }
+}
+
+IRrecv::IRrecv( int pin )
+{
+    this->pin = pin;
+}
+
+void IRrecv::enableIRIn()
+{
+}
+
+int IRrecv::decode( decode_results* results )
+{
+    if ( simIRHead == simIRTail ) {
+        return 0;
+    }
+    results->value = simIRCodes[ simIRTail ++ % SIM_IR_CODES ];
+    results->bits = 32;
+    results->decode_type = NEC;
+    return 1;
+}
+
+void IRrecv::resume()
+{
+}
+
+// END
@@ -0,0 +1,339 @@
+/*
+ * Simulated hardware for the host build, so that any object graph can be run, measured and regression tested
+ * without an Arduino.
+ *
+ * The global 'simulation' holds :
+ *   - The virtual pins. The sketch's digitalWrite()s set the pins' output levels, and the test code sets the
+ *     levels of input pins with setPin() (and analog values with setAnalog()).
+ *   - The simulated devices (shift registers, multiplexers, MCP23017s ...), which watch the pins (or the I2C bus)
+ *     and respond just like the real chips.
+ *   - Counters of every hardware operation (digitalRead, digitalWrite, shiftOut, analogRead, I2C bytes ...).
+ *   - The simulated time. Each operation costs roughly the number of cycles it takes on a 16MHz Uno (see SimCosts),
+ *     and millis() and micros() return the total. The cost of your own code isn't included, use advance()
+ *     to simulate that.
+ *
+ * Example :
+ *
+ *     Sim74HC595 leds( 2, 3, 4, 2 ); // data, clock and latch pins, and 2 chips.
+ *     BufferedShiftRegister* buffer = (new LatchedShiftRegister( 2, 3, 4 ))->buffer( 2 );
+ *
+ *     simulation.reset();
+ *     buffer->set( 3, true );
+ *     buffer->update();
+ *     simulation.report( "update" ); // Prints the operations and cycles used since reset().
+ *     if ( ! leds.output( 3 ) ) ... // Check that the LED really is on.
+ *
+ * The device models are register-level : Sim74HC595, Sim74HC165, Sim4051, Sim74HC138 and SimMCP23017.
+ * Write your own by subclassing SimDevice (or SimI2CDevice).
+ */
+
+#ifndef simulation_h
+#define simulation_h
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIM_PINS 64 // Pins 0..63 can be used, although an Uno only has 0..19 (A5).
+#define SIM_NO_PIN 0xff // For a device's optional pins.
+
+class SimCosts;
+class SimCounters;
+class SimDevice;
+class SimI2CDevice;
+class Simulation;
+
+/*
+ * The number of cycles each operation takes (roughly, on a 16MHz Uno).
+ * I2C and SPI bytes are calculated from the clock speed (Wire.setClock and SPISettings), plus an overhead.
+ */
+class SimCosts
+{
+  public :
+    unsigned int pinMode;
+    unsigned int digitalRead;
+    unsigned int digitalWrite;
+    unsigned int analogRead; // Mostly the ADC's conversion time (104us).
+    unsigned int analogWrite;
+    unsigned int shiftOut; // Per byte (16 digitalWrites plus the loop).
+    unsigned int shiftIn; // Per byte.
+    unsigned int i2cTransaction; // Wire's overhead per start..stop, on top of the bytes.
+    unsigned int i2cByte; // Wire's overhead per byte, on top of the 9 bits on the wire.
+    unsigned int spiByte; // SPI's overhead per byte, on top of the 8 bits on the wire.
+
+    SimCosts();
+};
+
+/*
+ * Counts of hardware operations. All are zeroed by Simulation::reset().
+ */
+class SimCounters
+{
+  public :
+    unsigned long pinModes;
+    unsigned long digitalReads;
+    unsigned long digitalWrites;
+    unsigned long analogReads;
+    unsigned long analogWrites;
+    unsigned long shiftOuts; // Bytes shifted out using shiftOut().
+    unsigned long shiftIns; // Bytes shifted in using shiftIn().
+    unsigned long i2cBytes; // Including the address bytes.
+    unsigned long i2cTransactions; // start..stop sequences (a repeated start doesn't count as a new transaction).
+    unsigned long spiBytes;
+    uint64_t cycles; // The simulated cost of all of the above.
+
+    SimCounters();
+    void clear();
+};
+
+/*
+ * Base class for the simulated chips. Devices add themselves to the simulation when they are constructed.
+ */
+class SimDevice
+{
+  public :
+    SimDevice* nextDevice;
+
+    SimDevice();
+    virtual ~SimDevice();
+
+    // Called whenever the level of an output pin changes (including the edges generated by shiftOut and SPI).
+    virtual void pinChanged( uint8_t pin, uint8_t level );
+
+    // If this device drives 'pin', set level, and return true.
+    virtual bool drivesPin( uint8_t pin, uint8_t* level );
+
+    // If this device drives 'pin' with an analog voltage, set value (0..1023), and return true.
+    virtual bool drivesAnalog( uint8_t pin, int* value );
+};
+
+/*
+ * Base class for simulated I2C chips. Each I2C transfer is delivered as start(), then write()s or read()s, then
+ * stop(). (A repeated start is just another start() without a stop()).
+ */
+class SimI2CDevice : public SimDevice
+{
+  public :
+    uint8_t address; // The 7 bit I2C address
+
+    SimI2CDevice( uint8_t address );
+
+    virtual void start( bool reading );
+    virtual void write( uint8_t value );
+    virtual uint8_t read();
+    virtual void stop();
+};
+
+class Simulation
+{
+  public :
+    SimCounters counters;
+    SimCosts costs;
+
+    unsigned long i2cClock; // As set by Wire.setClock()
+    unsigned long spiClock; // As set by the last SPI.beginTransaction()
+
+  protected :
+    uint8_t modes[ SIM_PINS ];
+    uint8_t outputs[ SIM_PINS ]; // The levels written by digitalWrite
+    uint8_t inputs[ SIM_PINS ]; // The levels set by setPin()
+    bool inputSet[ SIM_PINS ]; // Has setPin() been called for each pin?
+    int analogs[ SIM_PINS ];
+
+    SimDevice* devices; // A linked list of all devices.
+    uint64_t time; // In cycles (unlike counters.cycles, this isn't reset).
+
+  public :
+    Simulation();
+
+    // Zeroes the counters (but not the time).
+    void reset();
+
+    // Moves time forwards, without counting any operations (e.g. to simulate the time taken by your own code).
+    void advance( unsigned long micros );
+
+    // The simulated time since the program started.
+    uint64_t cycles();
+    unsigned long micros();
+
+    // The REAL time on this PC, in nanoseconds. Used to measure the library's own code, which isn't simulated.
+    uint64_t hostNanos();
+
+    // Sets the level of an input pin, as if it were connected to a switch.
+    void setPin( uint8_t pin, uint8_t level );
+    // Sets the value returned by analogRead (0..1023).
+    void setAnalog( uint8_t pin, int value );
+
+    // The level last written to an output pin (or HIGH for INPUT_PULLUP).
+    uint8_t pin( uint8_t pin );
+    // The pin's mode (INPUT, OUTPUT or INPUT_PULLUP).
+    uint8_t mode( uint8_t pin );
+
+    // Prints the counters (since reset()) as a single line, starting with 'label'.
+    void report( const char* label, FILE* out = stdout );
+
+    // Used by the simulated devices and the mock Arduino functions. These do NOT count the operations.
+    void add( SimDevice* device );
+    void remove( SimDevice* device );
+    SimI2CDevice* findI2C( uint8_t address );
+    void spend( uint64_t cycles ); // Adds to both the time and counters.cycles.
+    void setMode( uint8_t pin, uint8_t mode );
+    void write( uint8_t pin, uint8_t level );
+    uint8_t read( uint8_t pin );
+    int readAnalog( uint8_t pin );
+};
+
+extern Simulation simulation;
+
+/*
+ * A chain of 74HC595 shift registers (or 74HC164s, with no latch pin).
+ * Data is shifted in on the clock's rising edge, and copied to the outputs on the latch's rising edge.
+ * Output 0 is QA of the first chip (the one connected to the Arduino), output 8 is QA of the second chip, etc.
+ */
+class Sim74HC595 : public SimDevice
+{
+  protected :
+    uint8_t dataPin;
+    uint8_t clockPin;
+    uint8_t latchPin;
+    uint8_t chips;
+    uint8_t* shifted;
+    uint8_t* latched;
+
+  public :
+    unsigned long clocks; // The number of rising edges of the clock.
+    unsigned long latches; // The number of rising edges of the latch.
+
+    Sim74HC595( uint8_t dataPin, uint8_t clockPin, uint8_t latchPin = SIM_NO_PIN, uint8_t chips = 1 );
+    virtual ~Sim74HC595();
+
+    uint8_t output( uint8_t index );
+    uint8_t outputByte( uint8_t chip ); // Bit 0 is QA.
+
+    virtual void pinChanged( uint8_t pin, uint8_t level );
+};
+
+/*
+ * A chain of 74HC165 parallel-in shift registers.
+ * While the load pin is LOW, the inputs are copied into the shift register. On each rising edge of the clock
+ * (while the load pin is HIGH), the register shifts towards QH, which drives the data pin.
+ * Input 0 is A of the first chip (the one connected to the Arduino), and H of the first chip is read first.
+ */
+class Sim74HC165 : public SimDevice
+{
+  protected :
+    uint8_t dataPin;
+    uint8_t clockPin;
+    uint8_t loadPin;
+    uint8_t chips;
+    uint8_t* inputs;
+    uint8_t* shifted;
+
+  public :
+    Sim74HC165( uint8_t dataPin, uint8_t clockPin, uint8_t loadPin, uint8_t chips = 1 );
+    virtual ~Sim74HC165();
+
+    void setInput( uint8_t index, uint8_t level );
+    void setInputByte( uint8_t chip, uint8_t value ); // Bit 0 is A.
+
+    virtual void pinChanged( uint8_t pin, uint8_t level );
+    virtual bool drivesPin( uint8_t pin, uint8_t* level );
+};
+
+/*
+ * A 4051 8 channel analog multiplexer. The address pins select which channel is connected to the common pin,
+ * which is read by the Arduino using digitalRead or analogRead.
+ */
+class Sim4051 : public SimDevice
+{
+  protected :
+    uint8_t addressPins[3];
+    uint8_t commonPin;
+    uint8_t inhibitPin;
+    int values[8]; // 0..1023
+
+  public :
+    unsigned long switches; // The number of times the selected channel has changed (including any transients).
+
+    Sim4051( uint8_t s0, uint8_t s1, uint8_t s2, uint8_t commonPin, uint8_t inhibitPin = SIM_NO_PIN );
+
+    void setChannel( uint8_t channel, uint8_t level );
+    void setAnalog( uint8_t channel, int value );
+
+    uint8_t selected();
+
+    virtual void pinChanged( uint8_t pin, uint8_t level );
+    virtual bool drivesPin( uint8_t pin, uint8_t* level );
+    virtual bool drivesAnalog( uint8_t pin, int* value );
+
+  protected :
+    uint8_t previous;
+};
+
+/*
+ * A 74HC138 3 to 8 line decoder. The selected output is LOW, the others are HIGH.
+ * The (active LOW) enable pin is optional.
+ */
+class Sim74HC138 : public SimDevice
+{
+  protected :
+    uint8_t addressPins[3];
+    uint8_t enablePin;
+
+  public :
+    unsigned long changes; // The number of times the selected output has changed (including any transients).
+
+    Sim74HC138( uint8_t a0, uint8_t a1, uint8_t a2, uint8_t enablePin = SIM_NO_PIN );
+
+    uint8_t output( uint8_t index );
+    int selected(); // The output which is LOW, or -1 if disabled.
+
+    virtual void pinChanged( uint8_t pin, uint8_t level );
+
+  protected :
+    int previous;
+};
+
+/*
+ * An MCP23017 16 bit I/O expander, with IOCON.BANK = 0 (the power-on default).
+ * Models the register file, the address pointer's auto-increment (unless IOCON.SEQOP is set), input polarity,
+ * pullups, and interrupt-on-change (INTF, INTCAP, and the INTA pin, if connected to an Arduino pin).
+ */
+class SimMCP23017 : public SimI2CDevice
+{
+  public :
+    uint8_t registers[ 0x16 ];
+
+  protected :
+    uint16_t pins; // The levels of the external inputs.
+    uint16_t connected; // Which pins have been set by setInput() (the others float, or are pulled up).
+    uint8_t pointer;
+    bool addressed; // Has the first byte (the register address) been written?
+    uint8_t interruptPin;
+
+  public :
+    SimMCP23017( uint8_t address = 0 /* 0..7 */, uint8_t interruptPin = SIM_NO_PIN );
+
+    void setInput( uint8_t pin, uint8_t level );
+    uint8_t output( uint8_t pin ); // The level of an output pin.
+
+    uint16_t iodir();
+    uint16_t olat();
+
+    virtual void start( bool reading );
+    virtual void write( uint8_t value );
+    virtual uint8_t read();
+
+    virtual bool drivesPin( uint8_t pin, uint8_t* level );
+
+  protected :
+    uint16_t levels(); // The levels of all 16 pins.
+    uint16_t get( uint8_t registerID ); // Both banks of a register pair.
+    void set( uint8_t registerID, uint16_t value );
+};
+
+/*
+ * Simulated IR remote codes (for abstractRemote). Each code is returned once by IRrecv::decode().
+ */
+void simulateIRCode( unsigned long value );
+
+#endif
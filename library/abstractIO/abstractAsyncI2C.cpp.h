@@ -0,0 +1,241 @@
+// See abstractAsyncI2C.h for why this has a weird .cpp.h suffix.
+
+#include <abstractAsyncI2C.h>
+
+#include <util/twi.h>
+
+#include <abstractMCP23x17.cpp.h>
+
+#ifndef ABSTRACT_PORT_REGISTERS
+#error "abstractAsyncI2C is only supported on AVR based boards"
+#endif
+
+#define ABSTRACT_ASYNC_I2C_TRANSFERS_MASK (ABSTRACT_ASYNC_I2C_TRANSFERS - 1)
+#define ABSTRACT_ASYNC_I2C_DATA_MASK (ABSTRACT_ASYNC_I2C_DATA - 1)
+
+// The values written to TWCR. Each clears TWINT, which starts the TWI hardware's next step.
+#define ABSTRACT_TWI_START (_BV( TWINT ) | _BV( TWEN ) | _BV( TWIE ) | _BV( TWSTA ))
+#define ABSTRACT_TWI_NEXT (_BV( TWINT ) | _BV( TWEN ) | _BV( TWIE ))
+#define ABSTRACT_TWI_ACK (_BV( TWINT ) | _BV( TWEN ) | _BV( TWIE ) | _BV( TWEA )) // Receive a byte, then ask for more.
+#define ABSTRACT_TWI_STOP (_BV( TWINT ) | _BV( TWEN ) | _BV( TWSTO ))
+
+// ASYNC I2C BUS
+
+// The bus which is driven by the TWI interrupt. There can only be one.
+AsyncI2CBus* abstractAsyncI2CBus;
+
+ISR( TWI_vect )
+{
+    abstractAsyncI2CBus->interrupt();
+}
+
+AsyncI2CBus::AsyncI2CBus( unsigned long clock )
+{
+    this->clock = clock;
+    this->started = false;
+    this->errors = 0;
+    this->head = 0;
+    this->tail = 0;
+    this->dataHead = 0;
+    this->dataTail = 0;
+    this->index = 0;
+}
+
+void AsyncI2CBus::begin()
+{
+    if ( ! this->started ) {
+        this->started = true;
+        abstractAsyncI2CBus = this;
+
+        // Enable the internal pullups (the same as Wire does).
+        ::digitalWrite( SDA, HIGH );
+        ::digitalWrite( SCL, HIGH );
+
+        TWSR = 0; // A prescaler of 1.
+        this->setClock( this->clock );
+        TWCR = _BV( TWEN );
+    }
+}
+
+void AsyncI2CBus::setClock( unsigned long clock )
+{
+    this->clock = clock;
+    if ( this->started ) {
+        TWBR = ((F_CPU / clock) - 16) / 2;
+    }
+}
+
+boolean AsyncI2CBus::busy()
+{
+    return this->head != this->tail;
+}
+
+void AsyncI2CBus::startRead( byte i2cAddress, byte registerID, byte count, byte* values, AsyncI2CCallback callback, void* context )
+{
+    this->queue( i2cAddress, registerID, count, values, callback, context );
+
+    this->transactions ++;
+    IO_PROFILE( busTransactions, 1 );
+    this->bytes += 3 + count; // The address (twice), the register, and the data.
+    IO_PROFILE( busBytes, 3 + count );
+}
+
+void AsyncI2CBus::startWrite( byte i2cAddress, byte registerID, byte count, byte* values, AsyncI2CCallback callback, void* context )
+{
+    // Wait for room in the data buffer. The interrupt frees each byte as it is sent.
+    while ( (byte) (ABSTRACT_ASYNC_I2C_DATA - (byte) (this->dataHead - this->dataTail)) < count ) {
+    }
+    byte h = this->dataHead;
+    for ( byte i = 0; i < count; i ++ ) {
+        this->data[ h & ABSTRACT_ASYNC_I2C_DATA_MASK ] = values[i];
+        h ++;
+    }
+    this->dataHead = h;
+
+    this->queue( i2cAddress, registerID, count, NULL, callback, context );
+
+    this->transactions ++;
+    IO_PROFILE( busTransactions, 1 );
+    this->bytes += 2 + count; // The address, the register, and the data.
+    IO_PROFILE( busBytes, 2 + count );
+}
+
+void AsyncI2CBus::queue( byte i2cAddress, byte registerID, byte count, byte* values, AsyncI2CCallback callback, void* context )
+{
+    this->begin();
+
+    // Wait for room in the queue.
+    while ( (byte) (this->head - this->tail) >= ABSTRACT_ASYNC_I2C_TRANSFERS ) {
+    }
+
+    AsyncI2CTransfer* transfer = &this->transfers[ this->head & ABSTRACT_ASYNC_I2C_TRANSFERS_MASK ];
+    transfer->address = i2cAddress;
+    transfer->registerID = registerID;
+    transfer->count = count;
+    transfer->values = values;
+    transfer->callback = callback;
+    transfer->context = context;
+
+    // If the queue was empty, then the interrupt has stopped, so start this transfer ourselves.
+    uint8_t oldSREG = SREG;
+    cli();
+    boolean idle = this->head == this->tail;
+    this->head ++;
+    if ( idle ) {
+        this->startTransfer();
+    }
+    SREG = oldSREG;
+}
+
+void AsyncI2CBus::readRegisters( byte i2cAddress, byte registerID, byte count, byte* values )
+{
+    this->startRead( i2cAddress, registerID, count, values );
+    this->wait();
+}
+
+void AsyncI2CBus::writeRegisters( byte i2cAddress, byte registerID, byte count, byte* values )
+{
+    this->startWrite( i2cAddress, registerID, count, values );
+    this->wait();
+}
+
+void AsyncI2CBus::startReadRegisters( byte i2cAddress, byte registerID, byte count, byte* values )
+{
+    this->startRead( i2cAddress, registerID, count, values );
+}
+
+void AsyncI2CBus::startWriteRegisters( byte i2cAddress, byte registerID, byte count, byte* values )
+{
+    this->startWrite( i2cAddress, registerID, count, values );
+}
+
+void AsyncI2CBus::startTransfer()
+{
+    // The previous transfer's stop condition may still be being sent.
+    while ( TWCR & _BV( TWSTO ) ) {
+    }
+    this->index = 0;
+    TWCR = ABSTRACT_TWI_START;
+}
+
+void AsyncI2CBus::finishTransfer( boolean success )
+{
+    AsyncI2CTransfer* transfer = &this->transfers[ this->tail & ABSTRACT_ASYNC_I2C_TRANSFERS_MASK ];
+    if ( ! success ) {
+        this->errors ++;
+        if ( transfer->values == NULL ) {
+            this->dataTail += transfer->count - this->index; // Discard the data which wasn't sent.
+        }
+    }
+    TWCR = ABSTRACT_TWI_STOP;
+
+    AsyncI2CCallback callback = transfer->callback;
+    void* context = transfer->context;
+    this->tail ++; // Now the transfer's slot can be reused.
+    if ( callback != NULL ) {
+        callback( context, success );
+    }
+
+    if ( this->head != this->tail ) {
+        this->startTransfer();
+    }
+}
+
+void AsyncI2CBus::interrupt()
+{
+    AsyncI2CTransfer* transfer = &this->transfers[ this->tail & ABSTRACT_ASYNC_I2C_TRANSFERS_MASK ];
+
+    switch ( TW_STATUS ) {
+
+    case TW_START :
+        TWDR = (transfer->address << 1) | TW_WRITE;
+        TWCR = ABSTRACT_TWI_NEXT;
+        break;
+
+    case TW_MT_SLA_ACK :
+        TWDR = transfer->registerID;
+        TWCR = ABSTRACT_TWI_NEXT;
+        break;
+
+    case TW_MT_DATA_ACK :
+        if ( transfer->values != NULL ) {
+            // The register has been sent. Now read from it, using a repeated start.
+            TWCR = ABSTRACT_TWI_START;
+        } else if ( this->index < transfer->count ) {
+            TWDR = this->data[ this->dataTail & ABSTRACT_ASYNC_I2C_DATA_MASK ];
+            this->dataTail ++;
+            this->index ++;
+            TWCR = ABSTRACT_TWI_NEXT;
+        } else {
+            this->finishTransfer( true );
+        }
+        break;
+
+    case TW_REP_START :
+        TWDR = (transfer->address << 1) | TW_READ;
+        TWCR = ABSTRACT_TWI_NEXT;
+        break;
+
+    case TW_MR_SLA_ACK :
+        // Acknowledge each byte, except the last, which tells the chip to stop sending.
+        TWCR = transfer->count > 1 ? ABSTRACT_TWI_ACK : ABSTRACT_TWI_NEXT;
+        break;
+
+    case TW_MR_DATA_ACK :
+        transfer->values[ this->index ++ ] = TWDR;
+        TWCR = this->index < transfer->count - 1 ? ABSTRACT_TWI_ACK : ABSTRACT_TWI_NEXT;
+        break;
+
+    case TW_MR_DATA_NACK :
+        transfer->values[ this->index ++ ] = TWDR;
+        this->finishTransfer( true );
+        break;
+
+    default :
+        // The chip didn't acknowledge, arbitration was lost, or a bus error.
+        this->finishTransfer( false );
+        break;
+    }
+}
+
+// END
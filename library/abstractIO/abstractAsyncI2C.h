@@ -0,0 +1,133 @@
+/*
+ * An I2C bus for MCP23017s which doesn't wait for the transfers to finish.
+ *
+ * Wire waits until the whole transaction has finished, which at 100kHz is a few hundred microseconds for each
+ * chip, every frame. AsyncI2CBus drives the Arduino's TWI hardware itself, from the TWI interrupt.
+ * startRead() and startWrite() add the transfer to a queue and return straight away; the interrupt works through
+ * the queue, one byte at a time, and calls an optional callback as each transfer completes.
+ *
+ * Use it in place of the global i2cBus (the chips' constructors take the bus as their 2nd parameter),
+ * and set 'prefetch', so that endFrame() starts reading the inputs for the next frame in the background :
+ *
+ *     AsyncI2CBus asyncBus;
+ *     BufferedMCP23017 expander( 0, &asyncBus );
+ *
+ *     void setup() {
+ *         asyncBus.prefetch = true;
+ *         ...
+ *     }
+ *
+ *     void loop() {
+ *         asyncBus.beginFrame(); // Waits for the inputs which were read during the previous loop.
+ *         ...
+ *         asyncBus.endFrame(); // Starts writing the outputs and reading the inputs, then returns immediately.
+ *         ... Any other slow work happens while the I2C transfers complete ...
+ *     }
+ *
+ * With prefetch, the inputs are read at the end of the previous frame, rather than at the start of this one.
+ *
+ * The blocking readRegisters() and writeRegisters() (used when configuring the chips, and by MCP23017) still work;
+ * they queue the transfer, and then wait for the queue to empty. So do not use them from an interrupt, or with
+ * interrupts disabled.
+ *
+ * NOTE. This defines the TWI interrupt handler, which Wire also defines, so do NOT include Wire.h (or
+ * abstractMCP23017.cpp.h) in the same sketch. Include abstractAsyncI2C.cpp.h once in your sketch, rather than
+ * this file. Only supported on AVR based boards.
+ */
+
+#ifndef abstractAsyncI2C_h
+#define abstractAsyncI2C_h
+
+#include <Arduino.h>
+#include "abstractMCP23017.h"
+
+// The maximum number of queued transfers. Must be a power of 2, and no more than 128.
+#ifndef ABSTRACT_ASYNC_I2C_TRANSFERS
+#define ABSTRACT_ASYNC_I2C_TRANSFERS 8
+#endif
+
+// The size of the buffer holding the data of queued writes. Must be a power of 2, and no more than 128.
+#ifndef ABSTRACT_ASYNC_I2C_DATA
+#define ABSTRACT_ASYNC_I2C_DATA 32
+#endif
+
+class AsyncI2CTransfer;
+class AsyncI2CBus;
+
+// Called (from the TWI interrupt) when a transfer finishes. success is false if the chip didn't acknowledge.
+typedef void (*AsyncI2CCallback)( void* context, boolean success );
+
+/*
+ * Used internally by AsyncI2CBus. One queued read or write.
+ */
+class AsyncI2CTransfer
+{
+  public :
+    byte address;
+    byte registerID;
+    byte count;
+    byte* values; // Where to put the data, or NULL for a write (which takes its data from AsyncI2CBus's data buffer).
+    AsyncI2CCallback callback;
+    void* context;
+};
+
+class AsyncI2CBus : public ExpanderBus
+{
+  public :
+    // The number of transfers which failed (the chip didn't acknowledge). Updated by the interrupt.
+    volatile unsigned int errors;
+
+  protected :
+    unsigned long clock;
+    boolean started;
+
+    // The queue of transfers. The first (at tail) is the one in progress.
+    AsyncI2CTransfer transfers[ ABSTRACT_ASYNC_I2C_TRANSFERS ];
+    volatile byte head; // The number of transfers added (wraps around). Only changed by queue().
+    volatile byte tail; // The number of transfers completed (wraps around). Only changed by the interrupt.
+
+    // The data for queued writes, in the same order as the transfers.
+    byte data[ ABSTRACT_ASYNC_I2C_DATA ];
+    volatile byte dataHead; // Only changed by startWrite().
+    volatile byte dataTail; // Only changed by the interrupt.
+
+    byte index; // The number of data bytes sent or received so far, by the transfer in progress.
+
+  public :
+    // clock : The I2C clock speed in Hz. The MCP23017 can go up to 1700000 (but an Uno can only go up to 400000).
+    AsyncI2CBus( unsigned long clock = 100000 );
+
+    virtual void begin();
+
+    void setClock( unsigned long clock );
+
+    /*
+     * Queues a read of 'count' consecutive registers. 'values' must remain valid until the read has finished.
+     * Waits if the queue is full.
+     */
+    void startRead( byte address, byte registerID, byte count, byte* values, AsyncI2CCallback callback = NULL, void* context = NULL );
+
+    /*
+     * Queues a write of 'count' consecutive registers. The values are copied, so 'values' can be reused straight away.
+     * Waits if the queue is full. count must be no more than ABSTRACT_ASYNC_I2C_DATA.
+     */
+    void startWrite( byte address, byte registerID, byte count, byte* values, AsyncI2CCallback callback = NULL, void* context = NULL );
+
+    // Is a transfer queued or in progress?
+    virtual boolean busy();
+
+    virtual void readRegisters( byte address, byte registerID, byte count, byte* values );
+    virtual void writeRegisters( byte address, byte registerID, byte count, byte* values );
+
+    virtual void startReadRegisters( byte address, byte registerID, byte count, byte* values );
+    virtual void startWriteRegisters( byte address, byte registerID, byte count, byte* values );
+
+    void interrupt(); // Called by the TWI interrupt.
+
+  protected :
+    void queue( byte address, byte registerID, byte count, byte* values, AsyncI2CCallback callback, void* context );
+    void startTransfer(); // Sends a start condition for the transfer at tail.
+    void finishTransfer( boolean success ); // Sends a stop, and moves on to the next transfer.
+};
+
+#endif
@@ -0,0 +1,196 @@
+// See abstractButtonEvents.h for why this has a weird .cpp.h suffix.
+
+#include <abstractButtonEvents.h>
+#include <abstractPinChange.cpp.h>
+
+#define ABSTRACT_BUTTON_EVENTS_MASK (ABSTRACT_BUTTON_EVENTS - 1)
+
+// BUTTON EVENT QUEUE
+
+ButtonEventQueue::ButtonEventQueue( unsigned int debounceMillis )
+{
+    this->debounceMillis = debounceMillis;
+    this->overflows = 0;
+    this->head = 0;
+    this->tail = 0;
+    this->buttonCount = 0;
+    this->ports = NULL;
+    this->polled = NULL;
+}
+
+unsigned int ButtonEventQueue::addPin( byte pin, boolean trueReading, boolean enablePullup )
+{
+    if ( digitalPinToPCICR( pin ) == 0 ) {
+        // No pin change interrupt on this pin, so poll it instead.
+        return this->addInput( ABSTRACT_NEW( SimpleInput )( pin, trueReading, enablePullup ) );
+    }
+
+    pinMode( pin, enablePullup ? INPUT_PULLUP : INPUT );
+
+    byte port = digitalPinToPort( pin );
+    ButtonEventPort* bep = this->ports;
+    while ( bep != NULL && bep->port != port ) {
+        bep = bep->next;
+    }
+    if ( bep == NULL ) {
+        bep = ABSTRACT_NEW( ButtonEventPort )( this, pin );
+        bep->next = this->ports;
+        this->ports = bep;
+    }
+
+    unsigned int id = this->buttonCount ++;
+    bep->add( pin, trueReading, id );
+    attachPinChange( pin, bep );
+    return id;
+}
+
+unsigned int ButtonEventQueue::addInput( Input* input )
+{
+    PolledButton* pb = ABSTRACT_NEW( PolledButton )( input, this->buttonCount ++ );
+    pb->next = this->polled;
+    this->polled = pb;
+    return pb->id;
+}
+
+void ButtonEventQueue::poll()
+{
+    unsigned long now = millis();
+
+    for ( ButtonEventPort* bep = this->ports; bep != NULL; bep = bep->next ) {
+        bep->poll();
+    }
+
+    for ( PolledButton* pb = this->polled; pb != NULL; pb = pb->next ) {
+        boolean state = pb->input->get();
+        if ( state != pb->state && (unsigned int) ( (unsigned int) now - pb->changeTime ) >= this->debounceMillis ) {
+            pb->state = state;
+            pb->changeTime = now;
+
+            uint8_t oldSREG = SREG;
+            cli();
+            this->add( pb->id, state, now );
+            SREG = oldSREG;
+        }
+    }
+}
+
+// Must be called with interrupts disabled.
+void ButtonEventQueue::add( unsigned int id, boolean pressed, unsigned long time )
+{
+    byte h = this->head;
+    if ( (byte) (h - this->tail) >= ABSTRACT_BUTTON_EVENTS ) {
+        this->overflows ++;
+        return;
+    }
+
+    ButtonEvent* event = &this->events[ h & ABSTRACT_BUTTON_EVENTS_MASK ];
+    event->id = id;
+    event->pressed = pressed;
+    event->time = time;
+    this->head = h + 1;
+}
+
+boolean ButtonEventQueue::pollEvent( ButtonEvent* event )
+{
+    // add() never writes to the slot at tail while the queue is full, so this is safe without disabling interrupts.
+    byte t = this->tail;
+    if ( t == this->head ) {
+        return false;
+    }
+    *event = this->events[ t & ABSTRACT_BUTTON_EVENTS_MASK ];
+    this->tail = t + 1;
+    return true;
+}
+
+// BUTTON EVENT PORT
+
+ButtonEventPort::ButtonEventPort( ButtonEventQueue* queue, byte pin )
+{
+    this->queue = queue;
+    this->next = NULL;
+    this->port = digitalPinToPort( pin );
+    this->inputRegister = portInputRegister( this->port );
+    this->watched = 0;
+    this->trueMask = 0;
+    this->reported = 0;
+    this->locked = 0;
+}
+
+void ButtonEventPort::add( byte pin, boolean trueReading, unsigned int id )
+{
+    byte mask = digitalPinToBitMask( pin );
+    byte bit = 0;
+    while ( (1 << bit) != mask ) {
+        bit ++;
+    }
+
+    uint8_t oldSREG = SREG;
+    cli();
+    this->ids[ bit ] = id;
+    this->watched |= mask;
+    if ( trueReading ) {
+        this->trueMask |= mask;
+    }
+    // Start in the current state, so that no event is generated for the initial state.
+    this->reported = (this->reported & ~mask) | (*this->inputRegister & mask);
+    SREG = oldSREG;
+}
+
+// Must be called with interrupts disabled.
+void ButtonEventPort::update( unsigned long time )
+{
+    unsigned int debounce = this->queue->debounceMillis;
+    byte pins = *this->inputRegister;
+
+    // Release the pins which have finished debouncing.
+    if ( this->locked ) {
+        for ( byte i = 0; i < 8; i ++ ) {
+            if ( (this->locked & (1 << i)) && (unsigned int) ( (unsigned int) time - this->lockTime[i] ) >= debounce ) {
+                this->locked &= ~(1 << i);
+            }
+        }
+    }
+
+    byte changed = (pins ^ this->reported) & this->watched & ~this->locked;
+    if ( changed == 0 ) {
+        return;
+    }
+
+    for ( byte i = 0; i < 8; i ++ ) {
+        byte mask = 1 << i;
+        if ( changed & mask ) {
+            this->reported ^= mask;
+            this->queue->add( this->ids[i], (pins & mask) == (this->trueMask & mask), time );
+            if ( debounce ) {
+                this->locked |= mask;
+                this->lockTime[i] = time;
+            }
+        }
+    }
+}
+
+void ButtonEventPort::pinsChanged()
+{
+    this->update( millis() );
+}
+
+void ButtonEventPort::poll()
+{
+    uint8_t oldSREG = SREG;
+    cli();
+    this->update( millis() );
+    SREG = oldSREG;
+}
+
+// POLLED BUTTON
+
+PolledButton::PolledButton( Input* input, unsigned int id )
+{
+    this->next = NULL;
+    this->input = input;
+    this->id = id;
+    this->state = input->get();
+    this->changeTime = millis();
+}
+
+// END
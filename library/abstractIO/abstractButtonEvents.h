@@ -0,0 +1,154 @@
+/*
+ * An alternative to Button::pressed() and released(), for when you have lots of buttons.
+ *
+ * Rather than asking each button in turn if it has been pressed (which reads the input twice per button per loop),
+ * a ButtonEventQueue produces a queue of events, each with the button's id, whether it was pressed or released,
+ * and the time (in millis) that it happened. Your loop then calls pollEvent() until there are no more events.
+ *
+ * Buttons on the Arduino's own pins (addPin) are monitored using pin change interrupts, so even presses shorter
+ * than one loop() are seen. Any other Input (addInput), such as a MuxInput or MCP23017Input, is polled
+ * each time poll() is called, and an event is generated if it has changed since the last poll.
+ *
+ * Switches "bounce", which can generate lots of events for a single press. Set debounceMillis, and further
+ * changes to a pin are ignored for that long after each event. poll() then checks if the pin has settled in a
+ * different state, and if so, generates the missing event.
+ *
+ * Example :
+ *     ButtonEventQueue events;
+ *     int fire = events.addPin( 4 );
+ *
+ *     void loop() {
+ *         events.poll();
+ *         ButtonEvent event;
+ *         while ( events.pollEvent( &event ) ) {
+ *             if ( event.id == fire && event.pressed ) ...
+ *         }
+ *     }
+ *
+ * NOTE. This uses pin change interrupts, so it uses the .cpp.h bodge (see abstractPinChange.h).
+ * Include abstractButtonEvents.cpp.h once in your sketch (which also includes abstractPinChange.cpp.h).
+ * Only supported on AVR based boards.
+ */
+
+#ifndef abstractButtonEvents_h
+#define abstractButtonEvents_h
+
+#include <Arduino.h>
+#include "abstractIO.h"
+#include "abstractPinChange.h"
+
+// The size of the event queue. Must be a power of 2, and no more than 128.
+#ifndef ABSTRACT_BUTTON_EVENTS
+#define ABSTRACT_BUTTON_EVENTS 16
+#endif
+
+class ButtonEvent;
+class ButtonEventQueue;
+class ButtonEventPort;
+class PolledButton;
+
+class ButtonEvent
+{
+  public :
+    unsigned int id;    // As returned by ButtonEventQueue's addPin() or addInput().
+    boolean pressed;    // true for pressed, false for released.
+    unsigned long time; // The value of millis() when the change was seen.
+};
+
+class ButtonEventQueue
+{
+  friend class ButtonEventPort;
+
+  public :
+    // The number of events which were lost, because the queue was full.
+    volatile unsigned int overflows; // Updated by the pin change interrupt.
+
+    // Changes within this many milliseconds of the previous event for the same pin are ignored.
+    unsigned int debounceMillis;
+
+  protected :
+    ButtonEvent events[ ABSTRACT_BUTTON_EVENTS ];
+    volatile byte head; // The number of events added (wraps around).
+    volatile byte tail; // The number of events removed (wraps around).
+
+    unsigned int buttonCount;
+    ButtonEventPort* ports; // A linked list, one per port.
+    PolledButton* polled;   // A linked list of the Inputs which need to be polled.
+
+  public :
+    ButtonEventQueue( unsigned int debounceMillis = 0 );
+
+    /*
+     * Adds a button on one of the Arduino's pins, which is monitored using pin change interrupts.
+     * The parameters are the same as SimpleInput. Returns the button's id.
+     */
+    unsigned int addPin( byte pin, boolean trueReading = LOW /* or HIGH */, boolean enablePullup = true );
+
+    /*
+     * Adds any Input, which will be checked each time poll() is called. Returns the button's id.
+     */
+    unsigned int addInput( Input* input );
+
+    /*
+     * Checks the inputs added via addInput(), and finishes off debouncing for the pins added via addPin().
+     * Call this once per loop().
+     */
+    void poll();
+
+    /*
+     * Removes the oldest event from the queue, copying it into 'event'. Returns false if the queue is empty.
+     */
+    boolean pollEvent( ButtonEvent* event );
+
+  protected :
+    void add( unsigned int id, boolean pressed, unsigned long time );
+};
+
+/*
+ * Used internally by ButtonEventQueue. Monitors up to 8 pins of one port using a pin change interrupt.
+ */
+class ButtonEventPort : public PinChangeListener
+{
+  public :
+    ButtonEventPort* next;
+    byte port; // As returned by digitalPinToPort
+
+  protected :
+    ButtonEventQueue* queue;
+    volatile uint8_t* inputRegister;
+    byte watched;   // The pins being monitored
+    byte trueMask;  // The value for each pin when pressed
+    byte reported;  // The state of each pin when its last event was added.
+    byte locked;    // Pins which are being debounced.
+    unsigned int ids[8];
+    unsigned int lockTime[8]; // The low 16 bits of millis() when each pin was locked.
+
+  public :
+    ButtonEventPort( ButtonEventQueue* queue, byte pin );
+
+    void add( byte pin, boolean trueReading, unsigned int id );
+
+    virtual void pinsChanged();
+
+    void poll();
+
+  protected :
+    void update( unsigned long time );
+};
+
+/*
+ * Used internally by ButtonEventQueue. One of the Inputs which are polled.
+ */
+class PolledButton
+{
+  public :
+    PolledButton* next;
+    Input* input;
+    unsigned int id;
+    boolean state;
+    unsigned int changeTime; // The low 16 bits of millis() when the last event was added.
+
+    PolledButton( Input* input, unsigned int id );
+};
+
+#endif
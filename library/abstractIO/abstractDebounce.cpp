@@ -0,0 +1,110 @@
+#include "abstractDebounce.h"
+
+// DEBOUNCED INPUT BANK
+
+DebouncedInputBank::DebouncedInputBank( int debounceMillis, byte ticks )
+{
+    // The 4 bit counters can only count up to 15, i.e. ticks + 1.
+    if ( ticks < 1 || ticks > 14 ) {
+        IO_DEBUG2( "DebouncedInputBank ticks must be 1..14. Clamped", ticks );
+        ticks = ticks < 1 ? 1 : 14;
+    }
+
+    // An input is stable once its counter reaches ticks + 1, i.e. when it has been unchanged for
+    // at least debounceMillis (and at most one tick more).
+    this->ticks = ticks + 1;
+    this->tickMillis = debounceMillis / ticks;
+    if ( this->tickMillis == 0 ) {
+        this->tickMillis = 1;
+    }
+    this->tickTime = millis();
+
+    this->inputCount = 0;
+    this->state = 0;
+    this->previous = 0;
+    for ( byte p = 0; p < ABSTRACT_DEBOUNCE_PLANES; p ++ ) {
+        this->planes[p] = 0;
+    }
+}
+
+Input* DebouncedInputBank::createInput( Input* input )
+{
+    if ( this->inputCount >= ABSTRACT_DEBOUNCE_INPUTS ) {
+        IO_DEBUG1( "DebouncedInputBank full. Using a DebouncedInput" );
+        return ABSTRACT_NEW( DebouncedInput )( input, this->tickMillis * (this->ticks - 1) );
+    }
+
+    this->inputs[ this->inputCount ] = input;
+    if ( input->get() ) {
+        this->previous |= (DebounceBits) 1 << this->inputCount;
+    }
+    return ABSTRACT_NEW( DebouncedBankInput )( this, this->inputCount ++ );
+}
+
+void DebouncedInputBank::update()
+{
+    DebounceBits raw = 0;
+    DebounceBits mask = 1;
+    for ( byte i = 0; i < this->inputCount; i ++ ) {
+        if ( this->inputs[i]->get() ) {
+            raw |= mask;
+        }
+        mask <<= 1;
+    }
+    this->update( raw );
+}
+
+void DebouncedInputBank::update( DebounceBits raw )
+{
+    // Count the ticks since the last update. Each tick adds one to every counter (stopping at 'ticks').
+    unsigned long now = millis();
+    byte elapsed = 0;
+    while ( now - this->tickTime >= this->tickMillis ) {
+        this->tickTime += this->tickMillis;
+        if ( elapsed ++ >= this->ticks ) {
+            // All counters are already at their maximum, so there's no need to carry on counting.
+            this->tickTime = now;
+            break;
+        }
+
+        DebounceBits atMaximum = ~ (DebounceBits) 0;
+        for ( byte p = 0; p < ABSTRACT_DEBOUNCE_PLANES; p ++ ) {
+            atMaximum &= ( (this->ticks >> p) & 1 ) ? this->planes[p] : ~ this->planes[p];
+        }
+        DebounceBits carry = ~ atMaximum;
+        for ( byte p = 0; p < ABSTRACT_DEBOUNCE_PLANES; p ++ ) {
+            DebounceBits nextCarry = this->planes[p] & carry;
+            this->planes[p] ^= carry;
+            carry = nextCarry;
+        }
+    }
+
+    // Inputs which have changed start counting again (the same as DebouncedInput resetting its stableTime).
+    DebounceBits changed = raw ^ this->previous;
+    this->previous = raw;
+    for ( byte p = 0; p < ABSTRACT_DEBOUNCE_PLANES; p ++ ) {
+        this->planes[p] &= ~changed;
+    }
+
+    // Inputs whose counters have reached 'ticks' are stable.
+    DebounceBits stable = ~ (DebounceBits) 0;
+    for ( byte p = 0; p < ABSTRACT_DEBOUNCE_PLANES; p ++ ) {
+        stable &= ( (this->ticks >> p) & 1 ) ? this->planes[p] : ~ this->planes[p];
+    }
+    this->state = (this->state & ~stable) | (raw & stable);
+}
+
+// DEBOUNCED BANK INPUT
+
+DebouncedBankInput::DebouncedBankInput( DebouncedInputBank* bank, byte bit )
+{
+    this->bank = bank;
+    this->mask = (DebounceBits) 1 << bit;
+}
+
+boolean DebouncedBankInput::get()
+{
+    return (this->bank->state & this->mask) != 0;
+}
+
+// END
@@ -0,0 +1,90 @@
+/*
+ * Debounces lots of inputs at once.
+ *
+ * DebouncedInput needs a long, two booleans and a pointer for each input, and calls millis() every time get()
+ * is called. A DebouncedInputBank debounces up to 32 inputs (or 64, see ABSTRACT_DEBOUNCE_INPUTS) together,
+ * using "vertical counters", i.e. bit n of each of the counters' "planes" holds the count for input n, so
+ * all of the inputs are counted with a few bitwise operations.
+ *
+ * The behaviour is the same as DebouncedInput : an input's debounced value only changes after its raw value has
+ * stayed the same for debounceMillis. The time is measured in "ticks" of debounceMillis / ticks, so an input
+ * may take up to one tick longer than debounceMillis to settle.
+ *
+ * Call update() once per loop(), and then use the Inputs created by createInput() as normal.
+ * Alternatively, update( raw ) can be passed the raw values from elsewhere, such as an InputSampler's frames.
+ */
+
+#ifndef abstractDebounce_h
+#define abstractDebounce_h
+
+#include <Arduino.h>
+#include "abstractIO.h"
+
+// The maximum number of inputs. Use 8, 16, 32 or 64.
+#ifndef ABSTRACT_DEBOUNCE_INPUTS
+#define ABSTRACT_DEBOUNCE_INPUTS 32
+#endif
+
+#if ABSTRACT_DEBOUNCE_INPUTS <= 8
+typedef uint8_t DebounceBits;
+#elif ABSTRACT_DEBOUNCE_INPUTS <= 16
+typedef uint16_t DebounceBits;
+#elif ABSTRACT_DEBOUNCE_INPUTS <= 32
+typedef uint32_t DebounceBits;
+#else
+typedef uint64_t DebounceBits;
+#endif
+
+#define ABSTRACT_DEBOUNCE_PLANES 4 // So the counters go up to 15 ticks.
+
+class DebouncedInputBank;
+class DebouncedBankInput;
+
+class DebouncedInputBank
+{
+  public :
+    DebounceBits state; // The debounced values. Bit n is the nth input.
+
+  protected :
+    Input* inputs[ ABSTRACT_DEBOUNCE_INPUTS ];
+    byte inputCount;
+
+    DebounceBits previous; // The previous raw values
+    DebounceBits planes[ ABSTRACT_DEBOUNCE_PLANES ]; // The vertical counters
+    byte ticks; // The count at which an input is considered stable.
+    unsigned int tickMillis;
+    unsigned long tickTime; // millis() at the start of the current tick.
+
+  public :
+    // ticks : The number of steps that debounceMillis is divided into (1..14).
+    DebouncedInputBank( int debounceMillis = 50, byte ticks = 5 );
+
+    /*
+     * Adds an Input, returning its debounced version.
+     * If there are already ABSTRACT_DEBOUNCE_INPUTS inputs, then a DebouncedInput is returned instead.
+     */
+    Input* createInput( Input* input );
+
+    // Reads every Input added via createInput(), and then debounces them.
+    void update();
+
+    // Debounces the given raw values, (rather than reading the inputs). Bit n is the nth input.
+    void update( DebounceBits raw );
+};
+
+/*
+ * One bit of a DebouncedInputBank. Create these via DebouncedInputBank::createInput().
+ */
+class DebouncedBankInput : public Input
+{
+  protected :
+    DebouncedInputBank* bank;
+    DebounceBits mask;
+
+  public :
+    DebouncedBankInput( DebouncedInputBank* bank, byte bit );
+
+    virtual boolean get();
+};
+
+#endif
@@ -0,0 +1,250 @@
+#include "abstractFixed.h"
+
+// FIXED ANALOG INPUT
+
+EasedFixedAnalogInput* FixedAnalogInput::ease( FixedEase* ease )
+{
+    return ABSTRACT_NEW( EasedFixedAnalogInput )( this, ease );
+}
+
+ClippedFixedAnalogInput* FixedAnalogInput::clip( q15 minimum, q15 maximum )
+{
+    return ABSTRACT_NEW( ClippedFixedAnalogInput )( this, minimum, maximum );
+}
+
+ScaledFixedAnalogInput* FixedAnalogInput::scale( q15 scale )
+{
+    return ABSTRACT_NEW( ScaledFixedAnalogInput )( this, scale );
+}
+
+FixedToFloatAnalogInput* FixedAnalogInput::toFloat()
+{
+    return ABSTRACT_NEW( FixedToFloatAnalogInput )( this );
+}
+
+// SIMPLE FIXED ANALOG INPUT
+
+SimpleFixedAnalogInput::SimpleFixedAnalogInput( int pin )
+{
+    pinMode( pin, INPUT );
+    this->pin = pin;
+}
+
+q15 SimpleFixedAnalogInput::get()
+{
+    IO_PROFILE( analogReads, 1 );
+    q15 raw = analogRead( this->pin );
+    // Multiplying by 32 maps 1023 to 32736, so add a little bit more, so that 1023 maps to 32768 (Q15_ONE).
+    return (raw << 5) + ((raw + 16) >> 5);
+}
+
+// CLIPPED FIXED ANALOG INPUT
+
+ClippedFixedAnalogInput::ClippedFixedAnalogInput( FixedAnalogInput* wrap, q15 minimum, q15 maximum )
+  : wrapped( wrap )
+{
+    this->reversed = minimum > maximum;
+    this->low = this->reversed ? maximum : minimum;
+    this->high = this->reversed ? minimum : maximum;
+    this->factor = this->high == this->low ? 0 : ((uint32_t) Q15_ONE << 16) / (this->high - this->low);
+}
+
+q15 ClippedFixedAnalogInput::get()
+{
+    q15 raw = this->wrapped->get();
+    q15 result;
+
+    if ( raw <= this->low ) {
+        result = 0;
+    } else if ( raw >= this->high ) {
+        result = Q15_ONE;
+    } else {
+        // raw - low is less than high - low, so this cannot overflow.
+        result = ( (uint32_t) (raw - this->low) * this->factor ) >> 16;
+    }
+
+    return this->reversed ? Q15_ONE - result : result;
+}
+
+// SCALED FIXED ANALOG INPUT
+
+ScaledFixedAnalogInput::ScaledFixedAnalogInput( FixedAnalogInput* wrap, q15 scale )
+  : wrapped( wrap ), scale( scale )
+{
+}
+
+q15 ScaledFixedAnalogInput::get()
+{
+    return Q15_MULTIPLY( this->wrapped->get(), this->scale );
+}
+
+// EASED FIXED ANALOG INPUT
+
+EasedFixedAnalogInput::EasedFixedAnalogInput( FixedAnalogInput* wrap, FixedEase* ease )
+  : ease( ease ), wrapped( wrap )
+{
+}
+
+q15 EasedFixedAnalogInput::get()
+{
+    return this->ease->ease( this->wrapped->get() );
+}
+
+// FIXED TO FLOAT ANALOG INPUT
+
+FixedToFloatAnalogInput::FixedToFloatAnalogInput( FixedAnalogInput* wrap )
+  : wrapped( wrap )
+{
+}
+
+float FixedToFloatAnalogInput::get()
+{
+    return Q15_TO_FLOAT( this->wrapped->get() );
+}
+
+// FLOAT TO FIXED ANALOG INPUT
+
+FloatToFixedAnalogInput::FloatToFixedAnalogInput( AnalogInput* wrap )
+  : wrapped( wrap )
+{
+}
+
+q15 FloatToFixedAnalogInput::get()
+{
+    float value = this->wrapped->get();
+    return FLOAT_TO_Q15( value );
+}
+
+// FIXED PWM OUTPUT
+
+ScaledFixedPWMOutput* FixedPWMOutput::scale( q15 scale )
+{
+    return ABSTRACT_NEW( ScaledFixedPWMOutput )( this, scale );
+}
+
+EasedFixedPWMOutput* FixedPWMOutput::ease( FixedEase* ease )
+{
+    return ABSTRACT_NEW( EasedFixedPWMOutput )( this, ease );
+}
+
+FloatToFixedPWMOutput* FixedPWMOutput::toFloat()
+{
+    return ABSTRACT_NEW( FloatToFixedPWMOutput )( this );
+}
+
+// SIMPLE FIXED PWM OUTPUT
+
+SimpleFixedPWMOutput::SimpleFixedPWMOutput( int pin )
+{
+    this->pin = pin;
+    pinMode( pin, OUTPUT );
+}
+
+void SimpleFixedPWMOutput::set( q15 value )
+{
+    // The same as SimplePWMOutput, i.e. value * 255, rounded down.
+    uint16_t v = ( (uint32_t) value * 255 ) >> 15;
+    IO_PROFILE( analogWrites, 1 );
+    analogWrite( this->pin, v > 255 ? 255 : v );
+}
+
+// SCALED FIXED PWM OUTPUT
+
+ScaledFixedPWMOutput::ScaledFixedPWMOutput( FixedPWMOutput* wrap, q15 scale )
+  : wrapped( wrap ), scale( scale )
+{
+}
+
+void ScaledFixedPWMOutput::set( q15 value )
+{
+    this->wrapped->set( Q15_MULTIPLY( value, this->scale ) );
+}
+
+// EASED FIXED PWM OUTPUT
+
+EasedFixedPWMOutput::EasedFixedPWMOutput( FixedPWMOutput* wrap, FixedEase* ease )
+  : wrapped( wrap ), ease( ease )
+{
+}
+
+void EasedFixedPWMOutput::set( q15 value )
+{
+    this->wrapped->set( this->ease->ease( value ) );
+}
+
+// FIXED TO FLOAT PWM OUTPUT
+
+FixedToFloatPWMOutput::FixedToFloatPWMOutput( PWMOutput* wrap )
+  : wrapped( wrap )
+{
+}
+
+void FixedToFloatPWMOutput::set( q15 value )
+{
+    this->wrapped->set( Q15_TO_FLOAT( value ) );
+}
+
+// FLOAT TO FIXED PWM OUTPUT
+
+FloatToFixedPWMOutput::FloatToFixedPWMOutput( FixedPWMOutput* wrap )
+  : wrapped( wrap )
+{
+}
+
+void FloatToFixedPWMOutput::set( float value )
+{
+    this->wrapped->set( FLOAT_TO_Q15( value ) );
+}
+
+// FIXED EASE (various)
+
+q15 FixedLinear::ease( q15 from )
+{
+    return from;
+}
+FixedLinear fixedLinear = FixedLinear();
+
+q15 FixedJump::ease( q15 from )
+{
+    return from < Q15_ONE / 2 ? 0 : Q15_ONE;
+}
+FixedJump fixedJump = FixedJump();
+
+q15 FixedEaseInQuad::ease( q15 from )
+{
+    return Q15_MULTIPLY( from, from );
+}
+FixedEaseInQuad fixedEaseInQuad = FixedEaseInQuad();
+
+q15 FixedEaseInCubic::ease( q15 from )
+{
+    return Q15_MULTIPLY( Q15_MULTIPLY( from, from ), from );
+}
+FixedEaseInCubic fixedEaseInCubic = FixedEaseInCubic();
+
+q15 FixedEaseInQuart::ease( q15 from )
+{
+    q15 square = Q15_MULTIPLY( from, from );
+    return Q15_MULTIPLY( square, square );
+}
+FixedEaseInQuart fixedEaseInQuart = FixedEaseInQuart();
+
+q15 FixedEaseOutQuad::ease( q15 from )
+{
+    return Q15_ONE - fixedEaseInQuad.ease( Q15_ONE - from );
+}
+FixedEaseOutQuad fixedEaseOutQuad = FixedEaseOutQuad();
+
+q15 FixedEaseOutCubic::ease( q15 from )
+{
+    return Q15_ONE - fixedEaseInCubic.ease( Q15_ONE - from );
+}
+FixedEaseOutCubic fixedEaseOutCubic = FixedEaseOutCubic();
+
+q15 FixedEaseOutQuart::ease( q15 from )
+{
+    return Q15_ONE - fixedEaseInQuart.ease( Q15_ONE - from );
+}
+FixedEaseOutQuart fixedEaseOutQuart = FixedEaseOutQuart();
+
+// END
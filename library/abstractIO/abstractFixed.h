@@ -0,0 +1,310 @@
+/*
+ * Fixed point versions of AnalogInput, PWMOutput and Ease.
+ *
+ * The Arduino does floating point maths in software, which is slow (see AnalogInput). If you are reading lots
+ * of analog inputs, or fading lots of LEDs, then the classes here do the same jobs using 16 bit integers.
+ *
+ * Values are of type q15, where 0..1 is represented by 0..Q15_ONE (32768).
+ * Note that 1 is exactly 1<<15, which makes the maths simple, but it means that a q15 is unsigned, and
+ * cannot be negative.
+ *
+ * Converting from q15 to float is lossless, so you can mix and match, using the adapters FixedToFloatAnalogInput,
+ * FloatToFixedAnalogInput, FixedToFloatPWMOutput and FloatToFixedPWMOutput.
+ */
+
+#ifndef abstractFixed_h
+#define abstractFixed_h
+
+#include <Arduino.h>
+#include "abstractIO.h"
+
+typedef uint16_t q15;
+
+#define Q15_ONE 32768U
+
+// Converts between floats in the range 0..1, and q15. e.g. FLOAT_TO_Q15( 0.5 )
+#define FLOAT_TO_Q15( f ) ( (q15) ( (f) <= 0 ? 0 : (f) >= 1 ? Q15_ONE : (f) * Q15_ONE + 0.5f ) )
+#define Q15_TO_FLOAT( q ) ( (q) * (1.0f / Q15_ONE) )
+
+// Multiplies two q15 values. The result is exact when either value is 0 or 1.
+#define Q15_MULTIPLY( a, b ) ( (q15) ( ( (uint32_t) (a) * (b) ) >> 15 ) )
+
+class FixedAnalogInput;
+class SimpleFixedAnalogInput;
+class ClippedFixedAnalogInput;
+class ScaledFixedAnalogInput;
+class EasedFixedAnalogInput;
+class FixedToFloatAnalogInput;
+class FloatToFixedAnalogInput;
+
+class FixedPWMOutput;
+class SimpleFixedPWMOutput;
+class ScaledFixedPWMOutput;
+class EasedFixedPWMOutput;
+class FixedToFloatPWMOutput;
+class FloatToFixedPWMOutput;
+
+class FixedEase;
+class FixedLinear;
+class FixedJump;
+class FixedEaseInQuad;
+class FixedEaseInCubic;
+class FixedEaseInQuart;
+class FixedEaseOutQuad;
+class FixedEaseOutCubic;
+class FixedEaseOutQuart;
+
+/*
+ * The same as AnalogInput, but get() returns a q15 in the range 0..Q15_ONE.
+ */
+class FixedAnalogInput
+{
+  public :
+    virtual q15 get() = 0;
+
+    EasedFixedAnalogInput* ease( FixedEase* ease );
+
+    ClippedFixedAnalogInput* clip( q15 minimum, q15 maximum );
+
+    // NOTE. Unlike AnalogInput::scale, the result must stay within 0..1, so scale is also in the range 0..1
+    // (i.e. it can only make values smaller). To get values in another range, use toFloat()->scale( n ).
+    ScaledFixedAnalogInput* scale( q15 scale );
+
+    // An AnalogInput with the same values as this, but as floats. This conversion is lossless.
+    FixedToFloatAnalogInput* toFloat();
+};
+
+/*
+ * Uses analogRead. 0..1023 is mapped to 0..Q15_ONE (to within 1).
+ */
+class SimpleFixedAnalogInput : public FixedAnalogInput
+{
+  public :
+    int pin;
+
+  public :
+    SimpleFixedAnalogInput( int pin );
+
+    virtual q15 get();
+};
+
+/*
+ * See ClippedAnalogInput. The division is worked out in the constructor, so get() only needs a multiply.
+ * As with ClippedAnalogInput, the minimum can be larger than the maximum, which reverses the values.
+ */
+class ClippedFixedAnalogInput : public FixedAnalogInput
+{
+  private :
+    FixedAnalogInput* wrapped;
+    q15 low;
+    q15 high;
+    boolean reversed;
+    uint32_t factor; // (Q15_ONE << 16) / (high - low)
+
+  public :
+    ClippedFixedAnalogInput( FixedAnalogInput* wrap, q15 minimum, q15 maximum );
+
+    virtual q15 get();
+};
+
+/*
+ * Multiplies the value by scale, which is in the range 0..Q15_ONE.
+ */
+class ScaledFixedAnalogInput : public FixedAnalogInput
+{
+  private :
+    FixedAnalogInput* wrapped;
+    q15 scale;
+
+  public :
+    ScaledFixedAnalogInput( FixedAnalogInput* wrap, q15 scale );
+
+    virtual q15 get();
+};
+
+class EasedFixedAnalogInput : public FixedAnalogInput
+{
+  public :
+    FixedEase* ease;
+
+  private :
+    FixedAnalogInput* wrapped;
+
+  public :
+    EasedFixedAnalogInput( FixedAnalogInput* wrap, FixedEase* ease );
+
+    virtual q15 get();
+};
+
+/*
+ * Makes a FixedAnalogInput appear as a (regular) AnalogInput. This conversion is lossless.
+ */
+class FixedToFloatAnalogInput : public AnalogInput
+{
+  private :
+    FixedAnalogInput* wrapped;
+
+  public :
+    FixedToFloatAnalogInput( FixedAnalogInput* wrap );
+
+    virtual float get();
+};
+
+/*
+ * Makes a (regular) AnalogInput appear as a FixedAnalogInput. Values outside of the range 0..1 are clipped,
+ * and values are rounded to the nearest 1/32768th.
+ */
+class FloatToFixedAnalogInput : public FixedAnalogInput
+{
+  private :
+    AnalogInput* wrapped;
+
+  public :
+    FloatToFixedAnalogInput( AnalogInput* wrap );
+
+    virtual q15 get();
+};
+
+/*
+ * The same as PWMOutput, but set() takes a q15 in the range 0..Q15_ONE.
+ */
+class FixedPWMOutput
+{
+  public :
+    virtual void set( q15 value ) = 0;
+
+    // NOTE. Unlike PWMOutput::scale, this multiplies the values by scale (in the range 0..1),
+    // so it can be used as a "master" brightness.
+    ScaledFixedPWMOutput* scale( q15 scale );
+    EasedFixedPWMOutput* ease( FixedEase* ease );
+
+    // A PWMOutput which converts its values to q15 before passing them to this.
+    FloatToFixedPWMOutput* toFloat();
+};
+
+class SimpleFixedPWMOutput : public FixedPWMOutput
+{
+  public :
+    byte pin;
+
+  public :
+    SimpleFixedPWMOutput( int pin );
+
+    virtual void set( q15 value );
+};
+
+class ScaledFixedPWMOutput : public FixedPWMOutput
+{
+  private :
+    FixedPWMOutput* wrapped;
+    q15 scale;
+
+  public :
+    ScaledFixedPWMOutput( FixedPWMOutput* wrap, q15 scale );
+
+    virtual void set( q15 value );
+};
+
+class EasedFixedPWMOutput : public FixedPWMOutput
+{
+  private :
+    FixedPWMOutput* wrapped;
+
+  public :
+    FixedEase* ease;
+
+  public :
+    EasedFixedPWMOutput( FixedPWMOutput* wrap, FixedEase* ease );
+
+    virtual void set( q15 value );
+};
+
+/*
+ * Makes a (regular) PWMOutput appear as a FixedPWMOutput. This conversion is lossless.
+ */
+class FixedToFloatPWMOutput : public FixedPWMOutput
+{
+  private :
+    PWMOutput* wrapped;
+
+  public :
+    FixedToFloatPWMOutput( PWMOutput* wrap );
+
+    virtual void set( q15 value );
+};
+
+/*
+ * Makes a FixedPWMOutput appear as a (regular) PWMOutput. Values outside of the range 0..1 are clipped.
+ */
+class FloatToFixedPWMOutput : public PWMOutput
+{
+  private :
+    FixedPWMOutput* wrapped;
+
+  public :
+    FloatToFixedPWMOutput( FixedPWMOutput* wrap );
+
+    virtual void set( float value );
+};
+
+/*
+ * The same as Ease, but using q15 values.
+ */
+class FixedEase {
+  public :
+    virtual q15 ease( q15 from ) = 0;
+};
+
+class FixedLinear : public FixedEase {
+  public :
+    virtual q15 ease( q15 from );
+};
+
+class FixedJump : public FixedEase {
+  public :
+    virtual q15 ease( q15 from );
+};
+
+class FixedEaseInQuad : public FixedEase {
+  public :
+    virtual q15 ease( q15 from );
+};
+
+class FixedEaseInCubic : public FixedEase {
+  public :
+    virtual q15 ease( q15 from );
+};
+
+class FixedEaseInQuart : public FixedEase {
+  public :
+    virtual q15 ease( q15 from );
+};
+
+class FixedEaseOutQuad : public FixedEase {
+  public :
+    virtual q15 ease( q15 from );
+};
+
+class FixedEaseOutCubic : public FixedEase {
+  public :
+    virtual q15 ease( q15 from );
+};
+
+class FixedEaseOutQuart : public FixedEase {
+  public :
+    virtual q15 ease( q15 from );
+};
+
+/*
+Instances of each of the FixedEase classes.
+*/
+extern FixedLinear fixedLinear;
+extern FixedJump fixedJump;
+extern FixedEaseInQuad fixedEaseInQuad;
+extern FixedEaseInCubic fixedEaseInCubic;
+extern FixedEaseInQuart fixedEaseInQuart;
+extern FixedEaseOutQuad fixedEaseOutQuad;
+extern FixedEaseOutCubic fixedEaseOutCubic;
+extern FixedEaseOutQuart fixedEaseOutQuart;
+
+#endif
@@ -11,18 +11,260 @@ AbstractSerial::AbstractSerial( int baud ) {
     
 };
 
+// ARENA
+
+#ifdef ABSTRACT_ARENA_SIZE
+
+AbstractArena abstractArena;
+
+// Compares two type names (which are both in PROGMEM).
+// The same name used in different places may, or may not be at the same address, so compare the characters.
+static boolean abstractSameName( const char* a, const char* b )
+{
+    if ( a == b ) {
+        return true;
+    }
+    while ( pgm_read_byte( a ) == pgm_read_byte( b ) ) {
+        if ( pgm_read_byte( a ) == 0 ) {
+            return true;
+        }
+        a ++;
+        b ++;
+    }
+    return false;
+}
+
+void* AbstractArena::allocate( size_t size, const char* typeName )
+{
+    // Many processors (but not AVR) need objects to be aligned.
+    size = (size + __BIGGEST_ALIGNMENT__ - 1) & ~(__BIGGEST_ALIGNMENT__ - 1);
+
+    void* result;
+    if ( this->used + size <= ABSTRACT_ARENA_SIZE ) {
+        result = this->buffer + this->used;
+        this->used += size;
+    } else {
+        result = malloc( size );
+        this->overflow += size;
+    }
+
+    byte i = 0;
+    while ( i < this->typeCount && ! abstractSameName( this->typeNames[i], typeName ) ) {
+        i ++;
+    }
+    if ( i == this->typeCount && this->typeCount < ABSTRACT_ARENA_TYPES ) {
+        this->typeNames[ this->typeCount ++ ] = typeName;
+    }
+    if ( i < this->typeCount ) {
+        this->typeBytes[i] += size;
+        this->typeObjects[i] ++;
+    }
+
+    return result;
+}
+
+void AbstractArena::report()
+{
+    Serial.print( F("Arena used : ") ); Serial.print( this->used );
+    Serial.print( F(" of ") ); Serial.print( ABSTRACT_ARENA_SIZE );
+    Serial.print( F(" overflow : ") ); Serial.println( this->overflow );
+
+    for ( byte i = 0; i < this->typeCount; i ++ ) {
+        Serial.print( F("    ") ); Serial.print( (const __FlashStringHelper*) this->typeNames[i] );
+        Serial.print( F(" x") ); Serial.print( this->typeObjects[i] );
+        Serial.print( F(" : ") ); Serial.println( this->typeBytes[i] );
+    }
+}
+
+void* operator new( size_t size, AbstractArena& arena, const char* typeName )
+{
+    return arena.allocate( size, typeName );
+}
+
+void operator delete( void* object, AbstractArena& arena, const char* typeName )
+{
+}
+
+#endif
+
+// PROFILE
+
+#ifdef ABSTRACT_PROFILE
+
+AbstractProfiler abstractProfiler;
+
+IOProfile::IOProfile( const char* name )
+{
+    this->name = name;
+    this->parent = NULL;
+    this->depth = 0;
+    this->clear();
+    abstractProfiler.add( this );
+}
+
+void IOProfile::begin()
+{
+    if ( this->depth ++ == 0 ) {
+        this->parent = abstractProfiler.current;
+        abstractProfiler.current = this;
+        this->started = ::micros();
+    }
+}
+
+void IOProfile::end()
+{
+    if ( -- this->depth == 0 ) {
+        this->micros += ::micros() - this->started;
+        this->calls ++;
+        abstractProfiler.current = this->parent;
+    }
+}
+
+void IOProfile::clear()
+{
+    this->calls = 0;
+    this->micros = 0;
+    this->digitalReads = 0;
+    this->digitalWrites = 0;
+    this->analogReads = 0;
+    this->analogWrites = 0;
+    this->shiftedBytes = 0;
+    this->busBytes = 0;
+    this->busTransactions = 0;
+}
+
+void IOProfile::report()
+{
+    Serial.print( this->name );
+    Serial.print( F(" : calls ") ); Serial.print( this->calls );
+    Serial.print( F(" micros ") ); Serial.print( this->micros );
+    Serial.print( F(" digitalReads ") ); Serial.print( this->digitalReads );
+    Serial.print( F(" digitalWrites ") ); Serial.print( this->digitalWrites );
+    Serial.print( F(" analogReads ") ); Serial.print( this->analogReads );
+    Serial.print( F(" analogWrites ") ); Serial.print( this->analogWrites );
+    Serial.print( F(" shiftedBytes ") ); Serial.print( this->shiftedBytes );
+    Serial.print( F(" busBytes ") ); Serial.print( this->busBytes );
+    Serial.print( F(" busTransactions ") ); Serial.println( this->busTransactions );
+}
+
+void AbstractProfiler::add( IOProfile* profile )
+{
+    // Added to the end, so that report() lists the profiles in the order they were created.
+    IOProfile** last = &this->profiles;
+    while ( *last ) {
+        last = &(*last)->nextProfile;
+    }
+    profile->nextProfile = NULL;
+    *last = profile;
+}
+
+void AbstractProfiler::report()
+{
+    for ( IOProfile* profile = this->profiles; profile; profile = profile->nextProfile ) {
+        if ( profile->calls ) {
+            profile->report();
+        }
+    }
+    Serial.println();
+    this->clear();
+}
+
+void AbstractProfiler::clear()
+{
+    for ( IOProfile* profile = this->profiles; profile; profile = profile->nextProfile ) {
+        profile->clear();
+    }
+}
+
+Input* Input::profiled( const char* name )
+{
+    return ABSTRACT_NEW( ProfiledInput )( this, name );
+}
+
+Output* Output::profiled( const char* name )
+{
+    return ABSTRACT_NEW( ProfiledOutput )( this, name );
+}
+
+AnalogInput* AnalogInput::profiled( const char* name )
+{
+    return ABSTRACT_NEW( ProfiledAnalogInput )( this, name );
+}
+
+PWMOutput* PWMOutput::profiled( const char* name )
+{
+    return ABSTRACT_NEW( ProfiledPWMOutput )( this, name );
+}
+
+ProfiledInput::ProfiledInput( Input* wrap, const char* name ) : profile( name )
+{
+    this->wrapped = wrap;
+}
+
+boolean ProfiledInput::get()
+{
+    this->profile.begin();
+    boolean result = this->wrapped->get();
+    this->profile.end();
+    return result;
+}
+
+ProfiledOutput::ProfiledOutput( Output* wrap, const char* name ) : profile( name )
+{
+    this->wrapped = wrap;
+}
+
+void ProfiledOutput::set( boolean value )
+{
+    this->profile.begin();
+    this->wrapped->set( value );
+    this->profile.end();
+}
+
+ProfiledAnalogInput::ProfiledAnalogInput( AnalogInput* wrap, const char* name ) : profile( name )
+{
+    this->wrapped = wrap;
+}
+
+float ProfiledAnalogInput::get()
+{
+    this->profile.begin();
+    float result = this->wrapped->get();
+    this->profile.end();
+    return result;
+}
+
+ProfiledPWMOutput::ProfiledPWMOutput( PWMOutput* wrap, const char* name ) : profile( name )
+{
+    this->wrapped = wrap;
+}
+
+void ProfiledPWMOutput::set( float value )
+{
+    this->profile.begin();
+    this->wrapped->set( value );
+    this->profile.end();
+}
+
+#endif
+
+#ifdef ABSTRACT_PORT_REGISTERS
+// Used in place of a port register for pins which don't exist. Reads as LOW, and writes are ignored.
+volatile uint8_t abstractNotAPort = 0;
+#endif
+
 // INPUT
 
 Input* Input::debounced()
 {
-    return new DebouncedInput( this );
+    return ABSTRACT_NEW( DebouncedInput )( this );
 }
 
 // INPUT BUTTON
 
 InputButton* Input::button()
 {
-    return new InputButton( this );
+    return ABSTRACT_NEW( InputButton )( this );
 }
 
 // SIMPLE INPUT
@@ -33,12 +275,25 @@ SimpleInput::SimpleInput( int pin, boolean trueReading, boolean enablePullup )
     this->trueReading = trueReading;
     
     pinMode( pin, enablePullup ? INPUT_PULLUP : INPUT );
+
+#ifdef ABSTRACT_FAST_PINS
+    byte port = digitalPinToPort( pin );
+    this->inputRegister = port == NOT_A_PIN ? &abstractNotAPort : portInputRegister( port );
+    this->mask = digitalPinToBitMask( pin );
+    this->trueMask = trueReading ? this->mask : 0;
+    digitalRead( pin ); // Turns off the pin's PWM timer (if it has one).
+#endif
 }
 
 
 boolean SimpleInput::get()
 {
+    IO_PROFILE( digitalReads, 1 );
+#ifdef ABSTRACT_FAST_PINS
+    return (*this->inputRegister & this->mask) == this->trueMask;
+#else
     return digitalRead( this->pin ) == this->trueReading;
+#endif
 }
 
 
@@ -47,26 +302,61 @@ boolean SimpleInput::get()
 Mux::Mux( Selector *selector, byte inputPin )
 {
     this->selector = selector;
-    this->input = new SimpleInput(inputPin);
+    this->input = ABSTRACT_NEW( SimpleInput )( inputPin );
+    this->settleMicros = 0;
 }
 
 Mux::Mux( Selector *selector, Input* input )
 {
     this->selector = selector;
     this->input = input;
+    this->settleMicros = 0;
 }
 
 Input* Mux::createInput( byte address )
 {
-    return new MuxInput( this, address );
+    return ABSTRACT_NEW( MuxInput )( this, address );
 }
 
 boolean Mux::get( byte address )
 {
     this->selector->select( address );
+    if ( this->settleMicros ) {
+        delayMicroseconds( this->settleMicros );
+    }
     return this->input->get();
 }
 
+// The number of steps needed to scan 'count' addresses in Gray code order (the next power of 2).
+static byte muxScanSize( byte count )
+{
+    byte size = 1;
+    while ( size < count ) {
+        size <<= 1;
+    }
+    return size;
+}
+
+MuxBits Mux::scanAll( byte count, MuxBits enabled )
+{
+    if ( count > ABSTRACT_MUX_CHANNELS ) {
+        count = ABSTRACT_MUX_CHANNELS;
+    }
+    MuxBits result = 0;
+    byte size = muxScanSize( count );
+
+    for ( byte i = 0; i < size; i ++ ) {
+        byte address = i ^ (i >> 1); // Gray code
+        MuxBits bit = (MuxBits) 1 << address;
+        if ( address < count && (enabled & bit) ) {
+            if ( this->get( address ) ) {
+                result |= bit;
+            }
+        }
+    }
+    return result;
+}
+
 // MUX INPUT
 
 MuxInput::MuxInput( Mux *mux, byte address )
@@ -166,60 +456,132 @@ boolean BinaryInput::get()
 
 Mux* Selector::createMux( byte inputPin )
 {
-  return new Mux( this, inputPin );
+  return ABSTRACT_NEW( Mux )( this, inputPin );
 }
 
 Mux* Selector::createMux( Input* input )
 {
-  return new Mux( this, input );
+  return ABSTRACT_NEW( Mux )( this, input );
 }
 
 AnalogMux* Selector::createAnalogMux( byte inputPin )
 {
-  return new AnalogMux( this, new SimpleAnalogInput( inputPin ) );
+  return ABSTRACT_NEW( AnalogMux )( this, ABSTRACT_NEW( SimpleAnalogInput )( inputPin ) );
 }
 
 AnalogMux* Selector::createAnalogMux( AnalogInput *analogInput )
 {
-  return new AnalogMux( this, analogInput );
+  return ABSTRACT_NEW( AnalogMux )( this, analogInput );
 }
 
 // ADDRESS SELECTOR
 
 AddressSelector::AddressSelector( byte pinCount, byte *addressPins )
 {
+    // The address is a byte, so there can be at most 8 address pins (select() relies on this too).
+    if ( pinCount > 8 ) {
+        IO_DEBUG2( "AddressSelector has too many pins. Only using 8 of", pinCount );
+        pinCount = 8;
+    }
     this->pinCount = pinCount;
     this->addressPins = addressPins;
-    
-    select( 0 );
-
-    for ( byte i = 0; i < pinCount; i ++ ) {
-        pinMode( addressPins[i], OUTPUT );
-    }    
+    this->begin();
 }
 
 AddressSelector::AddressSelector( byte a0, byte a1, byte a2 )
 {
     this->pinCount = 3;
-    this->addressPins = (byte*) malloc( 3 );
+    this->addressPins = (byte*) ABSTRACT_MALLOC( 3, "AddressSelector pins" );
     this->addressPins[0] = a0;
     this->addressPins[1] = a1;
     this->addressPins[2] = a2;
-    
-    select( 0 );
+    this->begin();
+}
+
+void AddressSelector::begin()
+{
+#ifdef ABSTRACT_PORT_REGISTERS
+    // Group the address pins by port, so that pins on the same port can be changed together.
+    this->outputRegisters = (volatile uint8_t**) ABSTRACT_MALLOC( this->pinCount * sizeof( volatile uint8_t* ), "AddressSelector ports" );
+    this->portIndices = (byte*) ABSTRACT_MALLOC( this->pinCount, "AddressSelector ports" );
+    this->masks = (byte*) ABSTRACT_MALLOC( this->pinCount, "AddressSelector ports" );
+    this->portCount = 0;
+
+    for ( byte i = 0; i < this->pinCount; i ++ ) {
+        byte port = digitalPinToPort( this->addressPins[i] );
+        volatile uint8_t* outputRegister = port == NOT_A_PIN ? &abstractNotAPort : portOutputRegister( port );
+        byte p = 0;
+        while ( p < this->portCount && this->outputRegisters[p] != outputRegister ) {
+            p ++;
+        }
+        if ( p == this->portCount ) {
+            this->outputRegisters[ this->portCount ++ ] = outputRegister;
+        }
+        this->portIndices[i] = p;
+        this->masks[i] = digitalPinToBitMask( this->addressPins[i] );
+        digitalRead( this->addressPins[i] ); // Turns off the pin's PWM timer (if it has one).
+    }
+#endif
+
+    // Write every address pin (setting the level before the pin becomes an output).
+    this->address = (byte) ~0;
+    this->select( 0 );
 
-    pinMode( a0, OUTPUT );
-    pinMode( a1, OUTPUT );
-    pinMode( a2, OUTPUT );    
+    for ( byte i = 0; i < this->pinCount; i ++ ) {
+        pinMode( this->addressPins[i], OUTPUT );
+    }
 }
 
 void AddressSelector::select( byte address )
 {
+    byte changed = address ^ this->address;
+    if ( changed == 0 ) {
+        return;
+    }
+    this->address = address;
+
+#ifdef ABSTRACT_PORT_REGISTERS
+    // Work out which bits to set and clear on each port, then update each port in a single write,
+    // so that a line decoder never sees a mix of the old and new addresses (unless the pins are on different ports).
+    byte setMasks[8]; // There are at most 8 pins, and therefore at most 8 ports.
+    byte clearMasks[8];
+    for ( byte p = 0; p < this->portCount; p ++ ) {
+        setMasks[p] = 0;
+        clearMasks[p] = 0;
+    }
     byte digit = 1;
-    for ( byte i = 0; i < pinCount; i ++ ) {
-        digitalWrite( this->addressPins[i], address & digit );
+    for ( byte i = 0; i < this->pinCount; i ++ ) {
+        if ( changed & digit ) {
+            IO_PROFILE( digitalWrites, 1 );
+            if ( address & digit ) {
+                setMasks[ this->portIndices[i] ] |= this->masks[i];
+            } else {
+                clearMasks[ this->portIndices[i] ] |= this->masks[i];
+            }
+        }
         digit = digit << 1;
     }
+
+    // The read-modify-write must not be interrupted, in case an ISR writes to another pin on the same port.
+    uint8_t oldSREG = SREG;
+    cli();
+    for ( byte p = 0; p < this->portCount; p ++ ) {
+        if ( setMasks[p] | clearMasks[p] ) {
+            volatile uint8_t* outputRegister = this->outputRegisters[p];
+            *outputRegister = (*outputRegister & ~clearMasks[p]) | setMasks[p];
+        }
+    }
+    SREG = oldSREG;
+#else
+    byte digit = 1;
+    for ( byte i = 0; i < this->pinCount; i ++ ) {
+        if ( changed & digit ) {
+            IO_PROFILE( digitalWrites, 1 );
+            digitalWrite( this->addressPins[i], address & digit );
+        }
+        digit = digit << 1;
+    }
+#endif
 }
 
 // BOOLEAN SELECTOR
@@ -232,6 +594,7 @@ BooleanSelector::BooleanSelector( byte selectPin )
 
 void BooleanSelector::select(byte address)
 {
+    IO_PROFILE( digitalWrites, 1 );
     digitalWrite( selectPin, address );
 }
 
@@ -305,49 +668,93 @@ SimpleOutput::SimpleOutput( int pin, boolean lowValue )
     this->pin = pin;
     this->lowValue = lowValue;
     pinMode( this->pin, OUTPUT );
+
+#ifdef ABSTRACT_FAST_PINS
+    byte port = digitalPinToPort( pin );
+    this->outputRegister = port == NOT_A_PIN ? &abstractNotAPort : portOutputRegister( port );
+    this->mask = digitalPinToBitMask( pin );
+    digitalRead( pin ); // Turns off the pin's PWM timer (if it has one), without changing the output.
+#endif
 }
 
 void SimpleOutput::set( boolean value )
 {
+    IO_PROFILE( digitalWrites, 1 );
+#ifdef ABSTRACT_FAST_PINS
+    // The read-modify-write must not be interrupted, in case an ISR writes to another pin on the same port.
+    uint8_t oldSREG = SREG;
+    cli();
+    if ( value == lowValue ) {
+        *this->outputRegister &= ~this->mask;
+    } else {
+        *this->outputRegister |= this->mask;
+    }
+    SREG = oldSREG;
+#else
     digitalWrite( this->pin, value == lowValue ? LOW : HIGH );
+#endif
+}
+
+// BUFFERED INPUT
+
+BufferedInput::BufferedInput( byte *buffer, int index, boolean trueReading )
+{
+    this->mask = 1 << (index % 8);
+    this->buffer = buffer + index / 8;
+    this->trueMask = trueReading ? this->mask : 0;
+}
+
+boolean BufferedInput::get()
+{
+    return (*this->buffer & this->mask) == this->trueMask;
 }
 
 // BUFFERED OUTPUT
 
-BufferedOutput::BufferedOutput( byte *buffer, int index )
+BufferedOutput::BufferedOutput( byte *buffer, int index, boolean* dirty )
 {
     this->mask = 1 << (index % 8);
     this->buffer = buffer + index / 8;
+    this->dirty = dirty;
 }
 
 void BufferedOutput::set( boolean value )
 {
+    byte old = *this->buffer;
     *this->buffer |= this->mask;
     if ( ! value ) {
         *this->buffer ^= this->mask;
     }
+    if ( this->dirty && *this->buffer != old ) {
+        *this->dirty = true;
+    }
 }
 
 // ANALOG INPUT
 
 EasedAnalogInput* AnalogInput::ease( Ease* ease )
 {
-    return new EasedAnalogInput( this, ease );
+    return ABSTRACT_NEW( EasedAnalogInput )( this, ease );
 }
 
 ClippedAnalogInput* AnalogInput::clip( float minimum, float maximum )
 {
-    return new ClippedAnalogInput( this, minimum, maximum );
+    return ABSTRACT_NEW( ClippedAnalogInput )( this, minimum, maximum );
 }
 
 ScaledAnalogInput* AnalogInput::scale( float scale )
 {
-    return new ScaledAnalogInput( this, scale );
+    return ABSTRACT_NEW( ScaledAnalogInput )( this, scale );
+}
+
+FusedAnalogInput* AnalogInput::fused( float minimum, float maximum, float scale, Ease* ease )
+{
+    return ABSTRACT_NEW( FusedAnalogInput )( this, minimum, maximum, scale, ease );
 }
 
 BinaryInput* AnalogInput::binary( float calibration, boolean reversed )
 {
-    return new BinaryInput( this, calibration, reversed );
+    return ABSTRACT_NEW( BinaryInput )( this, calibration, reversed );
 }
 
 // SIMPLE ANALOG INPUT
@@ -360,6 +767,7 @@ SimpleAnalogInput::SimpleAnalogInput( int pin )
 
 float SimpleAnalogInput::get()
 {
+    IO_PROFILE( analogReads, 1 );
     float raw = analogRead( this->pin );
     return raw / 1023.0f; // NOTE. the range is 0..1 INCLUSIVE, therefore use 1023, not 1024.
 }
@@ -370,17 +778,36 @@ AnalogMux::AnalogMux( Selector *selector, AnalogInput *input )
 {
     this->selector = selector;
     this->input = input;
+    this->settleMicros = 0;
 }
 
 float AnalogMux::get( byte address )
 {
     this->selector->select( address );
+    if ( this->settleMicros ) {
+        delayMicroseconds( this->settleMicros );
+    }
     return this->input->get();
 }
 
+void AnalogMux::scanAll( byte count, float* values, MuxBits enabled )
+{
+    if ( count > ABSTRACT_MUX_CHANNELS ) {
+        count = ABSTRACT_MUX_CHANNELS;
+    }
+    byte size = muxScanSize( count );
+
+    for ( byte i = 0; i < size; i ++ ) {
+        byte address = i ^ (i >> 1); // Gray code
+        if ( address < count && (enabled & ((MuxBits) 1 << address)) ) {
+            values[ address ] = this->get( address );
+        }
+    }
+}
+
 AnalogInput* AnalogMux::createInput( byte address )
 {
-    return new AnalogMuxInput( this, address );
+    return ABSTRACT_NEW( AnalogMuxInput )( this, address );
 }
 
 // MUX ANALOG INPUT
@@ -450,17 +877,41 @@ float EasedAnalogInput::get()
     return this->ease->ease( this->wrapped->get() );
 }
 
+// FUSED ANALOG INPUT
+
+FusedAnalogInput::FusedAnalogInput( AnalogInput* wrap, float minimum, float maximum, float scale, Ease* ease )
+  : wrapped( wrap ), ease( ease )
+{
+    this->minimum = minimum;
+    this->factor = scale / (maximum - minimum);
+    this->low = scale < 0 ? scale : 0;
+    this->high = scale < 0 ? 0 : scale;
+}
+
+float FusedAnalogInput::get()
+{
+    float result = (this->wrapped->get() - this->minimum) * this->factor;
+
+    if ( result < this->low ) {
+        result = this->low;
+    } else if ( result > this->high ) {
+        result = this->high;
+    }
+
+    return this->ease == NULL ? result : this->ease->ease( result );
+}
+
 // PWM OUTPUT
 
 EasedPWMOutput* PWMOutput::ease( Ease *ease )
 {
-    return new EasedPWMOutput( this, ease );
+    return ABSTRACT_NEW( EasedPWMOutput )( this, ease );
 }
 
 
 ScaledPWMOutput* PWMOutput::scale( float scale )
 {
-    return new ScaledPWMOutput( this, scale );
+    return ABSTRACT_NEW( ScaledPWMOutput )( this, scale );
 }
 
 // SIMPLE PWM OUTPUT
@@ -474,6 +925,7 @@ SimplePWMOutput::SimplePWMOutput( int pin )
 void SimplePWMOutput::set( float value )
 {
     int v = value * 255.0f;
+    IO_PROFILE( analogWrites, 1 );
     analogWrite( this->pin, v);
 }
 
@@ -554,4 +1006,102 @@ float EaseOutQuart::ease( float from )
 }
 EaseOutQuart easeOutQuart = EaseOutQuart();
 
+// TABULATED EASE
+
+TabulatedEase::TabulatedEase( Ease* ease, int size, boolean interpolate )
+{
+    // ease() and easeByte() need at least the first and last entries.
+    if ( size < 2 ) {
+        IO_DEBUG2( "TabulatedEase size must be at least 2. Using", 2 );
+        size = 2;
+    }
+    uint16_t* table = (uint16_t*) ABSTRACT_MALLOC( sizeof(uint16_t) * size, "TabulatedEase table" );
+    for ( int i = 0; i < size; i ++ ) {
+        float value = ease->ease( i / (float) (size - 1) );
+        table[i] = value <= 0 ? 0 : value >= 1 ? 65535 : (uint16_t) (value * 65535.0f + 0.5f);
+    }
+
+    this->table = table;
+    this->size = size;
+    this->progmem = false;
+    this->interpolate = interpolate;
+}
+
+// Used in place of a PROGMEM table which is too small.
+static const uint16_t abstractLinearTable[2] = { 0, 65535 };
+
+TabulatedEase::TabulatedEase( const uint16_t* progmemTable, int size, boolean interpolate )
+{
+    if ( size < 2 ) {
+        IO_DEBUG2( "TabulatedEase table must have at least 2 entries. Using a linear ease instead of size", size );
+        this->table = abstractLinearTable;
+        this->size = 2;
+        this->progmem = false;
+    } else {
+        this->table = progmemTable;
+        this->size = size;
+        this->progmem = true;
+    }
+    this->interpolate = interpolate;
+}
+
+uint16_t TabulatedEase::entry( int index )
+{
+    return this->progmem ? pgm_read_word( this->table + index ) : this->table[index];
+}
+
+float TabulatedEase::ease( float from )
+{
+    if ( from <= 0 ) {
+        return this->entry( 0 ) / 65535.0f;
+    }
+    if ( from >= 1 ) {
+        return this->entry( this->size - 1 ) / 65535.0f;
+    }
+
+    float position = from * (this->size - 1);
+    if ( ! this->interpolate ) {
+        return this->entry( (int) (position + 0.5f) ) / 65535.0f;
+    }
+
+    int index = (int) position;
+    float a = this->entry( index );
+    float b = this->entry( index + 1 );
+    return (a + (b - a) * (position - index)) / 65535.0f;
+}
+
+byte TabulatedEase::easeByte( byte from )
+{
+    if ( this->size == 256 ) {
+        return this->entry( from ) >> 8;
+    }
+
+    // Work out the position in the table as index + remainder/255.
+    uint32_t position = (uint32_t) from * (this->size - 1);
+    int index = position / 255;
+    byte remainder = position % 255;
+
+    if ( remainder == 0 ) {
+        return this->entry( index ) >> 8;
+    }
+    if ( ! this->interpolate ) {
+        return this->entry( remainder < 128 ? index : index + 1 ) >> 8;
+    }
+
+    int32_t a = this->entry( index );
+    int32_t b = this->entry( index + 1 );
+    return (uint16_t) (a + (b - a) * remainder / 255) >> 8;
+}
+
+void TabulatedEase::printTable( const char* name )
+{
+    Serial.print( F("const uint16_t ") ); Serial.print( name );
+    Serial.print( F("[") ); Serial.print( this->size ); Serial.println( F("] PROGMEM = {") );
+    for ( int i = 0; i < this->size; i ++ ) {
+        Serial.print( this->entry( i ) );
+        Serial.print( i == this->size - 1 ? F("\n") : (i % 16 == 15) ? F(",\n") : F(", ") );
+    }
+    Serial.println( F("};") );
+}
+
 // END
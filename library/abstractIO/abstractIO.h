@@ -32,6 +32,155 @@
 
 #endif
 
+#if defined(__AVR__)
+#define ABSTRACT_PORT_REGISTERS // Whole ports can be read/written in one go via the PINx and PORTx registers.
+#endif
+
+// Uncomment the following line to make SimpleInput and SimpleOutput access the port registers directly,
+// rather than calling digitalRead and digitalWrite every time. The pin's register and bit mask are looked up
+// once (in the constructor), so get() and set() take a few cycles, rather than a few microseconds.
+// This is only used on AVR based boards. Note that a pin's PWM timer is only turned off when the SimpleInput
+// or SimpleOutput is created, so don't use analogWrite on the same pin afterwards.
+//#define ABSTRACT_FAST_PINS
+
+#if defined(ABSTRACT_FAST_PINS) && ! defined(ABSTRACT_PORT_REGISTERS)
+#undef ABSTRACT_FAST_PINS
+#endif
+
+// Uncomment the following line to create all of the library's objects (from methods such as Input::button(),
+// Selector::createMux() etc.) within a fixed size block of memory (an "arena"), rather than on the heap.
+// This avoids the heap's overhead of 2 bytes per object, and abstractArena.report() will tell you exactly
+// how much memory each type of object is using. Set the size to suit your project.
+//#define ABSTRACT_ARENA_SIZE 512
+
+// The maximum number of different types of object that abstractArena.report() can list.
+#ifndef ABSTRACT_ARENA_TYPES
+#define ABSTRACT_ARENA_TYPES 16
+#endif
+
+#ifdef ABSTRACT_ARENA_SIZE
+
+/*
+ * A simple "bump" allocator. Objects are never freed (abstractIO never deletes anything), so the number of
+ * bytes used is also the high water mark.
+ * If the arena is full, then objects are allocated from the heap instead, and 'overflow' records how many
+ * bytes didn't fit. Use report() to see if ABSTRACT_ARENA_SIZE needs changing.
+ *
+ * Note, there is no constructor, so the single instance (abstractArena) is zero filled before any other
+ * global variables are created, which means that it is safe to create objects within global variable definitions.
+ */
+class AbstractArena
+{
+  public :
+    unsigned int used;     // The number of bytes used (which is also the high water mark).
+    unsigned int overflow; // The number of bytes which didn't fit, and were allocated from the heap instead.
+
+  private :
+    byte buffer[ ABSTRACT_ARENA_SIZE ];
+    byte typeCount;
+    const char* typeNames[ ABSTRACT_ARENA_TYPES ]; // In PROGMEM
+    unsigned int typeBytes[ ABSTRACT_ARENA_TYPES ];
+    unsigned int typeObjects[ ABSTRACT_ARENA_TYPES ];
+
+  public :
+    // typeName must be in PROGMEM. See PSTR.
+    void* allocate( size_t size, const char* typeName );
+
+    // Prints the bytes used, the overflow, and the bytes used by each type of object to Serial.
+    void report();
+};
+
+extern AbstractArena abstractArena;
+
+void* operator new( size_t size, AbstractArena& arena, const char* typeName );
+void operator delete( void* object, AbstractArena& arena, const char* typeName ); // Not used, but keeps the compiler happy.
+
+// Use ABSTRACT_NEW( Type )( arguments ) in place of : new Type( arguments )
+#define ABSTRACT_NEW( type ) new ( abstractArena, PSTR( #type ) ) type
+#define ABSTRACT_MALLOC( size, name ) abstractArena.allocate( size, PSTR( name ) )
+
+#else
+
+#define ABSTRACT_NEW( type ) new type
+#define ABSTRACT_MALLOC( size, name ) malloc( size )
+
+#endif
+
+// Uncomment the following line to count the hardware operations (and time) used by individual objects.
+// Wrap the objects you are interested in using profiled( name ), e.g. :
+//     Input* button = (new SimpleInput( 2 ))->debounced()->profiled( "button" );
+// and call abstractProfiler.report() once per loop, to print (and then clear) the counts to Serial.
+// When this is commented out, profiled() returns the object itself, and all of the counting compiles to nothing.
+//#define ABSTRACT_PROFILE
+
+#ifdef ABSTRACT_PROFILE
+
+/*
+ * The hardware operations and time used by one object (or any other block of code, see begin() and end()).
+ * Profiles can be nested (e.g. a profiled DebouncedInput wrapping a profiled MuxInput), and the counts are
+ * inclusive, i.e. the operations performed by the MuxInput are counted by both profiles.
+ */
+class IOProfile
+{
+  public :
+    const char* name;
+    IOProfile* nextProfile; // A linked list of all profiles (see AbstractProfiler).
+    IOProfile* parent; // The profile which was active when begin() was called.
+
+    unsigned int calls;
+    unsigned long micros;
+    unsigned int digitalReads; // Including whole port reads, and reads of port registers.
+    unsigned int digitalWrites; // Including pins changed via the port registers.
+    unsigned int analogReads; // ADC conversions
+    unsigned int analogWrites;
+    unsigned int shiftedBytes; // In or out of shift registers (bit-banged or SPI).
+    unsigned int busBytes; // I2C bytes (or SPI bytes for an MCP23S17), including the address bytes.
+    unsigned int busTransactions;
+
+  protected :
+    byte depth; // The number of unfinished calls to begin(), so that recursion isn't counted twice.
+    unsigned long started;
+
+  public :
+    IOProfile( const char* name );
+
+    // Operations performed between begin() and end() are counted by this profile (and its parents).
+    void begin();
+    void end();
+
+    void clear();
+    void report(); // Prints a single line to Serial.
+};
+
+/*
+ * Keeps a list of all profiles. There is no constructor, so the single instance (abstractProfiler) is zero filled
+ * before any other global variables are created (just like AbstractArena).
+ */
+class AbstractProfiler
+{
+  public :
+    IOProfile* current; // The innermost profile between begin() and end(), or NULL.
+    IOProfile* profiles;
+
+    void add( IOProfile* profile );
+
+    // Prints a line for each profile which was used since the last report (and then clears them all).
+    void report();
+
+    void clear();
+};
+
+extern AbstractProfiler abstractProfiler;
+
+// Used by the library to count an operation. e.g. IO_PROFILE( digitalReads, 1 )
+#define IO_PROFILE( counter, n ) for ( IOProfile* ioProfile = abstractProfiler.current; ioProfile; ioProfile = ioProfile->parent ) { ioProfile->counter += (n); }
+
+#else
+
+#define IO_PROFILE( counter, n )
+
+#endif
+
 class AbstractSerial {
   public :
     AbstractSerial( int baud );
@@ -53,6 +202,7 @@ class CompoundButton;
 
 class Output;
 class SimpleOutput;
+class BufferedInput;
 class BufferedOutput;
 
 class AnalogInput;
@@ -60,6 +210,7 @@ class SimpleAnalogInput;
 class ClippedAnalogInput;
 class ScaledAnalogInput;
 class EasedAnalogInput;
+class FusedAnalogInput;
 class AnalogMuxInput;
 
 class PWMOutput;
@@ -81,10 +232,17 @@ class EaseInQuart;
 class EaseOutQuad;
 class EaseOutCubic;
 class EaseOutQuart;
+class TabulatedEase;
 
 class Mux;
 class AnalogMux;
 
+// Only when ABSTRACT_PROFILE is defined
+class ProfiledInput;
+class ProfiledOutput;
+class ProfiledAnalogInput;
+class ProfiledPWMOutput;
+
 /*
  * A digital input, returning true or false.
  * Abstract base class for all 'Input' classes.
@@ -101,6 +259,13 @@ class Input
     
     // Create a Button from this input.
     InputButton* button();
+
+    // Counts the hardware operations used by get() (see ABSTRACT_PROFILE). Returns this when not profiling.
+#ifdef ABSTRACT_PROFILE
+    Input* profiled( const char* name );
+#else
+    Input* profiled( const char* name ) { return this; }
+#endif
 };
 
 /*
@@ -116,6 +281,13 @@ class SimpleInput : public Input
     byte pin;
     byte trueReading;  // When is "true" returned, with a LOW or a HIGH reading?
 
+#ifdef ABSTRACT_FAST_PINS
+  protected :
+    volatile uint8_t* inputRegister; // The PINx register, looked up once in the constructor.
+    byte mask;
+    byte trueMask; // mask when trueReading is HIGH, otherwise 0.
+#endif
+
   public :
     // Use this for a simple switch, using the built in pullup resistor.
     SimpleInput( int pin ) : SimpleInput( pin, LOW, true ) {};
@@ -255,6 +427,13 @@ class CompoundButton : public Button
 class Output {
   public :
     virtual void set( boolean value ) = 0;
+
+    // Counts the hardware operations used by set() (see ABSTRACT_PROFILE). Returns this when not profiling.
+#ifdef ABSTRACT_PROFILE
+    Output* profiled( const char* name );
+#else
+    Output* profiled( const char* name ) { return this; }
+#endif
 };
 
 class SimpleOutput : public Output
@@ -262,20 +441,42 @@ class SimpleOutput : public Output
   public :
     int pin;
     boolean lowValue;
+
+#ifdef ABSTRACT_FAST_PINS
+  protected :
+    volatile uint8_t* outputRegister; // The PORTx register, looked up once in the constructor.
+    byte mask;
+#endif
     
   public :
     SimpleOutput( int pin, boolean lowVale = false );
     virtual void set( boolean value );    
 };
 
+/*
+ * Reads one bit from a buffer, which is filled by something else, such as a ParallelInShiftRegister.
+ */
+class BufferedInput : public Input
+{
+  public :
+    byte *buffer;
+    byte mask;
+    byte trueMask; // Either mask or 0, depending on trueReading.
+
+  public :
+    BufferedInput( byte* buffer, int index, boolean trueReading = HIGH /* or LOW */ );
+    virtual boolean get();
+};
+
 class BufferedOutput : public Output
 {
   public :
     byte *buffer;
     byte mask;
+    boolean *dirty; // If not NULL, this is set to true whenever set() changes the buffer.
     
   public :
-    BufferedOutput( boolean* buffer, int index );
+    BufferedOutput( byte* buffer, int index, boolean* dirty = NULL );
     virtual void set( boolean value );
 };
 
@@ -313,9 +514,20 @@ class AnalogInput
     // E.g. To control an RGB value, have three AnalogInputs, and scale them by 255.
     // This can also be used to adjust an AnalogInput whose values aren't within the usual range.
     ScaledAnalogInput* scale( float scale );
+
+    // Does the same as clip( minimum, maximum )->scale( scale )->ease( ease ), but using a single object,
+    // which is quicker. See FusedAnalogInput. ease can be NULL.
+    FusedAnalogInput* fused( float minimum, float maximum, float scale = 1, Ease* ease = NULL );
     
     // Converts an analog input into a digital (on/off) Input.
     BinaryInput* binary( float calibration = 0.5, boolean reversed = false );
+
+    // Counts the hardware operations used by get() (see ABSTRACT_PROFILE). Returns this when not profiling.
+#ifdef ABSTRACT_PROFILE
+    AnalogInput* profiled( const char* name );
+#else
+    AnalogInput* profiled( const char* name ) { return this; }
+#endif
 };
 
 /*
@@ -404,6 +616,32 @@ class EasedAnalogInput : public AnalogInput
     virtual float get();
 };
 
+/*
+ * Performs the same job as a chain of ClippedAnalogInput, ScaledAnalogInput and EasedAnalogInput, i.e.
+ *     input->clip( minimum, maximum )->scale( scale )->ease( ease )
+ * but in one object, with one virtual call to the wrapped input.
+ * The clip's division and the scale are combined into a single multiplication, which is calculated in the
+ * constructor. This saves the slow float division (see AnalogInput), but means that the result can differ
+ * from the chain of wrappers in the last bit of the float's precision.
+ */
+class FusedAnalogInput : public AnalogInput
+{
+  private :
+    AnalogInput* wrapped;
+    float minimum;
+    float factor; // scale / (maximum - minimum)
+    float low;    // The results are clipped to low..high (0..scale, or scale..0 for negative scales).
+    float high;
+
+  public :
+    Ease* ease; // May be NULL.
+
+  public :
+    FusedAnalogInput( AnalogInput* wrap, float minimum, float maximum, float scale = 1, Ease* ease = NULL );
+
+    virtual float get();
+};
+
 /*
  * Create an abstract layer, so that outputting PWM signals is simple for your application regardless of the details.
  * This may not sound useful if you only ever use PWM chips directly on the Arduino's ATMega chip, but what happens
@@ -413,9 +651,16 @@ class EasedAnalogInput : public AnalogInput
 class PWMOutput 
 {
   public :
-    virtual void set( float value ); // Range 0..1 inclusive
+    virtual void set( float value ) = 0; // Range 0..1 inclusive
     ScaledPWMOutput* scale( float scale );
     EasedPWMOutput* ease( Ease* ease );
+
+    // Counts the hardware operations used by set() (see ABSTRACT_PROFILE). Returns this when not profiling.
+#ifdef ABSTRACT_PROFILE
+    PWMOutput* profiled( const char* name );
+#else
+    PWMOutput* profiled( const char* name ) { return this; }
+#endif
 };
 
 class SimplePWMOutput : public PWMOutput
@@ -490,6 +735,10 @@ class Selector {
  * (at the expense of being slower, as the data is clocked into the  shift register sequentially).
  *
  * It can also be used as the address on multiplexers, such as the 4051 chip.
+ *
+ * Only the address pins which have changed since the previous select() are written. On AVR based boards,
+ * address pins which share a port are written together, in a single write to the port's register.
+ * So if all of the address pins are on the same port, the chips never see an intermediate address.
  * 
 */
 class AddressSelector : public Selector
@@ -497,9 +746,19 @@ class AddressSelector : public Selector
   protected :
     byte pinCount;
     byte* addressPins;
+    byte address; // The currently selected address.
+
+#ifdef ABSTRACT_PORT_REGISTERS
+    byte portCount; // The number of different ports used by the address pins.
+    volatile uint8_t** outputRegisters; // One per port.
+    byte* portIndices; // For each address pin, its index into outputRegisters.
+    byte* masks; // For each address pin, its bit within the port.
+#endif
+
+    void begin();
 
   public :
-    // The number of address pins, and their pin numbers.
+    // The number of address pins (at most 8), and their pin numbers.
     // Note, the LOW bit of the address must be first in the array.
     AddressSelector( byte pinCount, byte* addressPins );
     AddressSelector( byte a0, byte a1, byte a2 ); // A convienence, as many chips have three address lines
@@ -597,6 +856,51 @@ class EaseOutQuart : public Ease {
     virtual float ease( float from );
 };
 
+/*
+ * Samples another Ease into a table, so that ease() is a table look up, rather than a calculation.
+ * This works with any Ease, including your own.
+ *
+ * Entry i of the table holds the ease of i / (size - 1), stored as 0..65535 (for 0..1). size must be at least 2.
+ * Results outside of the range 0..1 are clipped.
+ * When interpolate is true, ease() interpolates between the two nearest entries, otherwise it uses the
+ * nearest entry.
+ *
+ * easeByte() maps 0..255 to 0..255 without any floating point maths, which is ideal for analogWrite.
+ * With a table size of 256, this is a direct look up.
+ *
+ * The table takes 2 bytes per entry of RAM. To save RAM, call printTable() once, paste the results
+ * into your sketch, and then use the second constructor, so that the table is in PROGMEM :
+ *     const uint16_t myTable[256] PROGMEM = { ... };
+ *     TabulatedEase myEase( myTable, 256 );
+ */
+class TabulatedEase : public Ease {
+  protected :
+    const uint16_t* table;
+    int size;
+    boolean progmem;
+
+  public :
+    boolean interpolate;
+
+  public :
+    // Builds the table (in RAM).
+    TabulatedEase( Ease* ease, int size = 256, boolean interpolate = true );
+
+    // Uses a table which is already in PROGMEM (see printTable()).
+    TabulatedEase( const uint16_t* progmemTable, int size, boolean interpolate = true );
+
+    virtual float ease( float from );
+
+    // 0..255 in, 0..255 out.
+    byte easeByte( byte from );
+
+    // Prints the table to Serial as C source code, which can be pasted into your sketch.
+    void printTable( const char* name );
+
+  protected :
+    uint16_t entry( int index );
+};
+
 /*
 Instances of each of the Ease classes.
 */
@@ -610,6 +914,23 @@ extern EaseOutCubic easeOutCubic;
 extern EaseOutQuart easeOutQuart;
 
 
+// The maximum number of channels that Mux::scanAll() and AnalogMux::scanAll() can read. Use 8, 16, 32 or 64.
+#ifndef ABSTRACT_MUX_CHANNELS
+#define ABSTRACT_MUX_CHANNELS 32
+#endif
+
+#if ABSTRACT_MUX_CHANNELS <= 8
+typedef uint8_t MuxBits;
+#elif ABSTRACT_MUX_CHANNELS <= 16
+typedef uint16_t MuxBits;
+#elif ABSTRACT_MUX_CHANNELS <= 32
+typedef uint32_t MuxBits;
+#else
+typedef uint64_t MuxBits;
+#endif
+
+#define MUX_ALL_CHANNELS ((MuxBits) ~ (MuxBits) 0)
+
 class Mux
 {
   protected :
@@ -617,6 +938,9 @@ class Mux
     Input *input;
 
   public :
+    // The time to wait after selecting an address, before reading the input. Defaults to 0.
+    unsigned int settleMicros;
+
     Mux( Selector *selector, byte inputPin );
     Mux( Selector *selector, Input *input );
 
@@ -626,6 +950,15 @@ class Mux
     Input* createInput( byte address );
     
     boolean get( byte address );
+
+    /*
+     * Reads addresses 0..count-1, returning the results as a bitmask (bit n is address n).
+     * Only addresses whose bit is set in 'enabled' are read (the others are 0 in the result).
+     * The addresses are visited in Gray code order (0, 1, 3, 2, 6, 7, 5, 4 ...), so that only one address line
+     * changes between consecutive reads (unless disabled addresses are skipped). This is quicker, and gives
+     * fewer glitches, than calling get() for each address in turn.
+     */
+    MuxBits scanAll( byte count, MuxBits enabled = MUX_ALL_CHANNELS );
 };
 
 /*
@@ -650,6 +983,8 @@ class AnalogMux
     AnalogInput *input;
 
   public :
+    // The time to wait after selecting an address, before reading the input. Defaults to 0.
+    unsigned int settleMicros;
       
     /*
      * Often, input will be a SimpleAnalogInput, however, you could apply wrappers (such as EasedAnalogInput)
@@ -666,7 +1001,61 @@ class AnalogMux
      * Gets the analog value for one of the multiplexed inputs.
      */
     float get( byte address );
+
+    /*
+     * Reads addresses 0..count-1 into values[0..count-1] (values[n] is address n).
+     * Only addresses whose bit is set in 'enabled' are read, the other values are left unchanged.
+     * The addresses are visited in Gray code order, the same as Mux::scanAll().
+     */
+    void scanAll( byte count, float* values, MuxBits enabled = MUX_ALL_CHANNELS );
 };
 
+#ifdef ABSTRACT_PROFILE
+
+/*
+ * Wrappers which count the hardware operations used by the wrapped object. Created by profiled( name ).
+ */
+class ProfiledInput : public Input
+{
+  public :
+    Input* wrapped;
+    IOProfile profile;
+
+    ProfiledInput( Input* wrap, const char* name );
+    virtual boolean get();
+};
+
+class ProfiledOutput : public Output
+{
+  public :
+    Output* wrapped;
+    IOProfile profile;
+
+    ProfiledOutput( Output* wrap, const char* name );
+    virtual void set( boolean value );
+};
+
+class ProfiledAnalogInput : public AnalogInput
+{
+  public :
+    AnalogInput* wrapped;
+    IOProfile profile;
+
+    ProfiledAnalogInput( AnalogInput* wrap, const char* name );
+    virtual float get();
+};
+
+class ProfiledPWMOutput : public PWMOutput
+{
+  public :
+    PWMOutput* wrapped;
+    IOProfile profile;
+
+    ProfiledPWMOutput( PWMOutput* wrap, const char* name );
+    virtual void set( float value );
+};
+
+#endif
+
 #endif
 
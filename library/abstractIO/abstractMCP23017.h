@@ -1,6 +1,8 @@
 /*
  * Interfaces with the MCP23017 using I2C interface.
- * This only gives access to basic IO, it does NOT support the interrupt pins.
+ * The MCP23S17 (the SPI version of the same chip) is also supported, see abstractMCP23S17.h.
+ * BufferedMCP23017 can use the chip's interrupt pins to avoid reading the chip when none of its inputs have changed
+ * (see BufferedMCP23017::useInterrupt()).
  * 
  * http://ww1.microchip.com/downloads/en/DeviceDoc/20001952C.pdf
  *
@@ -16,6 +18,119 @@
 #include <Arduino.h>
 #include <abstractIO.h>
 
+#define MCP23017_CONFIG_REGISTERS 14 // IODIRA (0x00) to GPPUB (0x0D).
+
+#define MCP23017_NO_INTERRUPT 0xff // For interruptMode(), and used by BufferedMCP23017 to mean "no interrupt pin".
+
+// The other modes for interruptMode(). Not Arduino's CHANGE, LOW and HIGH, as CHANGE is the same as HIGH.
+#define MCP23017_INTERRUPT_CHANGE 0
+#define MCP23017_INTERRUPT_LOW 1
+#define MCP23017_INTERRUPT_HIGH 2
+
+class ExpanderBus;
+class I2CBus;
+class AbstractMCP23017;
+class MCP23017;
+class BufferedMCP23017;
+class MCP23017Input;
+class MCP23017Output;
+
+/*
+ * The bus which MCP23017s (or MCP23S17s) are attached to. All traffic for the chips goes through here, so that
+ * it can be counted, and so that the BufferedMCP23017s can be read and written together, once per "frame" :
+ *
+ *     void loop() {
+ *         i2cBus.beginFrame(); // Reads the inputs of every BufferedMCP23017.
+ *         ... Use the inputs and outputs as normal ...
+ *         i2cBus.endFrame(); // Writes the outputs of the BufferedMCP23017s whose outputs have changed.
+ *     }
+ *
+ * See I2CBus, AsyncI2CBus (in abstractAsyncI2C.h), and MCP23S17Bus (in abstractMCP23S17.h).
+ */
+class ExpanderBus
+{
+  public :
+    // Counted since the start of the current frame (i.e. since beginFrame()).
+    unsigned int bytes; // The number of bytes sent or received, including the device address and register bytes.
+    unsigned int transactions; // The number of start..stop sequences (or chip selects for SPI).
+
+    // The totals for the last complete frame (as of the last endFrame()).
+    unsigned int frameBytes;
+    unsigned int frameTransactions;
+
+    // Bits which must always be set in the chips' IOCON register.
+    byte iocon;
+
+    // If set, endFrame() also starts reading the inputs for the next frame (only useful with an AsyncI2CBus).
+    boolean prefetch;
+
+  protected :
+    BufferedMCP23017* expanders; // A linked list of the BufferedMCP23017s on this bus.
+
+  public :
+    ExpanderBus();
+
+    // Called automatically the first time a chip is used. Therefore, do not use the bus before setup().
+    virtual void begin() = 0;
+
+    // BufferedMCP23017s are added automatically.
+    void add( BufferedMCP23017* expander );
+
+    // Reads the inputs of every BufferedMCP23017 on this bus.
+    void beginFrame();
+
+    // Writes the outputs of every BufferedMCP23017 on this bus, whose outputs have changed.
+    void endFrame();
+
+    /*
+     * Low level access to a chip's registers. 'address' is the chip's I2C address (0x20 to 0x27).
+     * count is at most 32 (the size of Wire's buffer).
+     */
+    virtual void readRegisters( byte address, byte registerID, byte count, byte* values ) = 0;
+    virtual void writeRegisters( byte address, byte registerID, byte count, byte* values ) = 0;
+
+    /*
+     * Start reading or writing, without waiting for it to finish. When reading, 'values' must remain valid
+     * until wait() returns. By default, these are the same as readRegisters and writeRegisters (i.e. they
+     * finish before returning). See AsyncI2CBus.
+     */
+    virtual void startReadRegisters( byte address, byte registerID, byte count, byte* values );
+    virtual void startWriteRegisters( byte address, byte registerID, byte count, byte* values );
+
+    // Is a read or write still in progress?
+    virtual boolean busy();
+
+    // Waits until all reads and writes have finished.
+    void wait();
+};
+
+/*
+ * The I2C bus, using Wire.
+ * Each read uses a "repeated start", so reading both banks of an MCP23017 is a single I2C transaction,
+ * and writes use the MCP23017's auto-increment, so writing both banks is also a single transaction.
+ *
+ * Unless told otherwise, every MCP23017 uses the global i2cBus.
+ */
+class I2CBus : public ExpanderBus
+{
+  protected :
+    unsigned long clock;
+    boolean started;
+
+  public :
+    // clock : The I2C clock speed in Hz. The MCP23017 can go up to 1700000 (but an Uno can only go up to 400000).
+    I2CBus( unsigned long clock = 100000 );
+
+    virtual void begin();
+
+    void setClock( unsigned long clock );
+
+    virtual void readRegisters( byte address, byte registerID, byte count, byte* values );
+    virtual void writeRegisters( byte address, byte registerID, byte count, byte* values );
+};
+
+extern I2CBus i2cBus;
+
 /*
  * Base class for MCP23017 and BufferedMCP23017.
  */
@@ -23,15 +138,42 @@ class AbstractMCP23017 {
 
   protected :
     byte i2cAddress;
+    ExpanderBus* bus;
+
+    // Copies of the chip's configuration registers (IODIRA..GPPUB) and output latches, so that changing
+    // one pin doesn't need to read the register first.
+    byte config[ MCP23017_CONFIG_REGISTERS ];
+    unsigned int olat;
+
+    boolean started; // Set when the shadow registers are first written to the chip (the first time the chip is used).
+    boolean batching; // Set between beginConfiguration() and endConfiguration().
+    byte firstDirty; // The range of config registers changed since they were last written.
+    byte lastDirty;
     
   public :
-    AbstractMCP23017( byte address );
+    AbstractMCP23017( byte address, ExpanderBus* bus = &i2cBus );
+
+    /*
+     * Configuration changes (pinMode, inputPolarity, interruptMode, and creating inputs and outputs) are normally
+     * written to the chip straight away. Between beginConfiguration() and endConfiguration() they are only
+     * made to the copy of the registers, and endConfiguration() writes them in a single I2C transaction.
+     */
+    void beginConfiguration();
+    void endConfiguration();
       
     void pinMode( byte pinNumber /* 0..15 */, byte mode /*INPUT, OUTPUT or INPUT_PULLUP */ );
     
     // If value is true, then the input logic is reversed (useful for buttons with pullup resistors).
     void inputPolarity( byte pinNumber /* 0..15 */, boolean value );
 
+    /*
+     * Sets when the pin causes an interrupt (on the chip's INTA/INTB pins), using the GPINTEN, DEFVAL and INTCON registers.
+     * MCP23017_INTERRUPT_CHANGE : Whenever the pin changes.
+     * MCP23017_INTERRUPT_LOW or MCP23017_INTERRUPT_HIGH : Whenever the pin is LOW (or HIGH).
+     * MCP23017_NO_INTERRUPT : Never.
+     */
+    void interruptMode( byte pinNumber /* 0..15 */, byte mode );
+
     virtual boolean digitalRead( byte pinNumber /* 0..15 */ ) = 0;
     virtual void digitalWrite( byte pinNumber /* 0..15 */, boolean value ) = 0; 
     
@@ -55,7 +197,16 @@ class AbstractMCP23017 {
     void writeRegister( byte registerID, byte value ); // Writes a single register
     void writeRegister2( byte registerID, unsigned int value ); // Writes two consecutive registers.
 
-    void setRegisterBit( byte registerID, byte bit, boolean value ); // Reads, adjusts one bit, then writes.
+    void writeRegisters( byte registerID, byte count, byte* values ); // Writes consecutive registers.
+
+    void setRegisterBit( byte registerID, byte bit, boolean value ); // Adjusts one bit, then writes (only if it changed).
+
+    // Writes the shadow registers to the chip the first time it is used (not in the constructor, as Wire
+    // doesn't work before setup()).
+    void begin();
+
+    // Writes the config registers which have changed (unless batching).
+    void flushConfiguration();
 
 };
 
@@ -67,13 +218,13 @@ class AbstractMCP23017 {
 class MCP23017 : public AbstractMCP23017 {
     
   public :
-    MCP23017( byte address = 0 );
+    MCP23017( byte address = 0, ExpanderBus* bus = &i2cBus );
         
     // Read the state of a single pin.
     virtual boolean digitalRead( byte pinNumber /* 0..15 */ );
     
     // Write the output of a single pin.
-    // Note, this performs a read, adjusts one bit, then writes.
+    // Note, this adjusts one bit of a shadow copy of the output latch, then writes the whole bank (if it changed).
     virtual void digitalWrite( byte pinNumber /* 0..15 */, boolean value ); 
     
 };
@@ -86,11 +237,20 @@ class MCP23017 : public AbstractMCP23017 {
  * 
  * A typical application can call read() once at the start of the main loop() method, and flush() once at the end of the loop() method.
  * digitalRead() and digitalWrite() can then be called wherever needed.
+ *
+ * If you have more than one BufferedMCP23017, then ExpanderBus's beginFrame() and endFrame() do this for all of them.
+ *
+ * Reading the inputs takes an I2C transaction every frame, even when nothing has changed. To avoid this, connect
+ * the chip's INTA (or INTB) pin to any Arduino pin, and call useInterrupt(). Then the chip is only read when its
+ * interrupt pin is LOW (i.e. when an input has changed). The interrupt pins are configured as "open drain",
+ * so the INTA pins of several chips can be connected to the same Arduino pin.
  */
 class BufferedMCP23017 : public AbstractMCP23017 {
     
   public :
-    BufferedMCP23017( byte address = 0 );
+    BufferedMCP23017* nextOnBus; // A linked list of all BufferedMCP23017 on the same ExpanderBus.
+
+    BufferedMCP23017( byte address = 0, ExpanderBus* bus = &i2cBus );
         
     // Read the state of a single pin.
     boolean digitalRead( byte pinNumber /* 0..15 */ );
@@ -99,13 +259,43 @@ class BufferedMCP23017 : public AbstractMCP23017 {
     void digitalWrite( byte pinNumber /* 0..15 */, boolean value ); 
 
     void read(); // Causes the next call to digitalRead to update the readBuffer
+    void fetch(); // Updates the readBuffer immediately (or waits for the prefetch to finish).
     void flush(); // Causes the outputBuffer to be written to the chip (if it differs from oldOutputBuffer).
+
+    /*
+     * Starts reading the inputs, without waiting (on a bus which supports it, such as AsyncI2CBus).
+     * The next fetch() (or read() then digitalRead()) waits for it to finish, and then uses the result.
+     * ExpanderBus::endFrame() calls this for every chip when the bus's 'prefetch' is set, so the inputs for the
+     * next frame are read while your code is busy with the current one.
+     */
+    void prefetch();
+
+    /*
+     * Only read the chip when arduinoPin (connected to the chip's INTA or INTB pin) is LOW.
+     * Interrupt-on-change is enabled for 'pins' (bit n for pin n), but only those configured as inputs,
+     * so call this after creating the inputs.
+     * Pins which already have an interrupt (from interruptMode()) keep their mode (e.g. MCP23017_INTERRUPT_LOW).
+     *
+     * The INTF, INTCAP and GPIO registers are read in a single burst. A pin which caused the interrupt reports
+     * the value captured in INTCAP, so that a short pulse is seen for one frame, even if it has already ended.
+     */
+    void useInterrupt( byte arduinoPin, unsigned int pins = 0xffff );
     
   protected :
     unsigned int inputBuffer;
     unsigned int outputBuffer;
     unsigned int oldOutputBuffer; // When outputBuffer != oldOutputBuffer, then a write is performed in flush().
     boolean readRequired; // Set within read(), and reset within digitalRead().
+
+    byte interruptPin; // The Arduino pin connected to the chip's INTA/INTB pins, or MCP23017_NO_INTERRUPT.
+    boolean pending; // Read the chip at the next fetch(), even if the interrupt pin is HIGH.
+
+    byte fetched[6]; // The registers read by startFetch(). GPIOA and B, or INTFA..GPIOB when using an interrupt.
+    byte fetchedCount; // The number of registers read by startFetch() (0 if the chip didn't need reading).
+    boolean prefetched; // Set by prefetch(), and reset by fetch().
+
+    void startFetch( boolean async ); // Reads the registers into 'fetched', if necessary.
+    void useFetched(); // Updates inputBuffer from the registers in 'fetched'.
 };
 
 class MCP23017Input : public Input {
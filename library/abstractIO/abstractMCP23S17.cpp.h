@@ -0,0 +1,75 @@
+/*
+ * NOTE. The weird .ccp.h file extension is a bodge to work around a problem with the Arduino IDE.
+ * See abstractMCP23017.cpp.h for details. In this case, the offending library is SPI.h rather than Wire.h.
+ */
+
+#include <abstractMCP23S17.h>
+
+#include <SPI.h>
+
+#include <abstractMCP23x17.cpp.h>
+
+#define MCP23S17_WRITE 0x00 // The low bit of the opcode.
+#define MCP23S17_READ 0x01
+
+// MCP23S17 BUS
+
+MCP23S17Bus::MCP23S17Bus( byte csPin, unsigned long clock ) : settings( clock, MSBFIRST, SPI_MODE0 )
+{
+    this->csPin = csPin;
+    this->started = false;
+    this->iocon = MCP23017_IOCON_HAEN; // Keep the address pins enabled whenever IOCON is written.
+}
+
+void MCP23S17Bus::begin()
+{
+    if ( ! this->started ) {
+        this->started = true;
+        ::pinMode( this->csPin, OUTPUT );
+        ::digitalWrite( this->csPin, HIGH );
+        SPI.begin();
+
+        // Until HAEN is set, every chip ignores its address pins, and responds to address 0.
+        // So this sets HAEN on every chip which shares this CS pin.
+        byte value = MCP23017_IOCON_HAEN;
+        this->writeRegisters( MCP23017_BASE_ADDRESS, MCP23017_IOCON, 1, &value );
+    }
+}
+
+void MCP23S17Bus::readRegisters( byte i2cAddress, byte registerID, byte count, byte* values )
+{
+    SPI.beginTransaction( this->settings );
+    ::digitalWrite( this->csPin, LOW );
+    SPI.transfer( (i2cAddress << 1) | MCP23S17_READ );
+    SPI.transfer( registerID );
+    for ( byte i = 0; i < count; i ++ ) {
+        values[i] = SPI.transfer( 0 );
+    }
+    ::digitalWrite( this->csPin, HIGH );
+    SPI.endTransaction();
+
+    this->transactions ++;
+    IO_PROFILE( busTransactions, 1 );
+    this->bytes += 2 + count; // The opcode, the register, and the data.
+    IO_PROFILE( busBytes, 2 + count );
+}
+
+void MCP23S17Bus::writeRegisters( byte i2cAddress, byte registerID, byte count, byte* values )
+{
+    SPI.beginTransaction( this->settings );
+    ::digitalWrite( this->csPin, LOW );
+    SPI.transfer( (i2cAddress << 1) | MCP23S17_WRITE );
+    SPI.transfer( registerID );
+    for ( byte i = 0; i < count; i ++ ) {
+        SPI.transfer( values[i] );
+    }
+    ::digitalWrite( this->csPin, HIGH );
+    SPI.endTransaction();
+
+    this->transactions ++;
+    IO_PROFILE( busTransactions, 1 );
+    this->bytes += 2 + count; // The opcode, the register, and the data.
+    IO_PROFILE( busBytes, 2 + count );
+}
+
+// END
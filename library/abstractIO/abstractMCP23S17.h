@@ -0,0 +1,67 @@
+/*
+ * The MCP23S17 is the SPI version of the MCP23017. It has the same registers, but SPI runs at up to 10MHz,
+ * rather than the MCP23017's 100kHz or 400kHz I2C, so reading or writing a chip takes a few microseconds
+ * rather than a few hundred.
+ *
+ * Use the same classes as the MCP23017 (MCP23017 and BufferedMCP23017), but pass an MCP23S17Bus to their
+ * constructors, so the rest of your code doesn't care which bus the chips are on :
+ *
+ *     MCP23S17Bus spiBus( 10 ); // The chips' CS pins are connected to Arduino pin 10.
+ *     BufferedMCP23017 expander( 0, &spiBus ); // The chip's A0..A2 pins are all connected to ground.
+ *     Input* button = expander.createInput( 0 );
+ *
+ *     void loop() {
+ *         spiBus.beginFrame();
+ *         ...
+ *         spiBus.endFrame();
+ *     }
+ *
+ * Up to 8 chips can share the same CS pin, using their A0..A2 pins to give each a different address
+ * (the same as the MCP23017). The MCP23S17 ignores these pins until the HAEN bit of its IOCON register is set,
+ * which MCP23S17Bus does when it is first used.
+ *
+ * Connect the chips' SI to MOSI, SO to MISO and SCK to SCK (on an Uno or Nano, these are pins 11, 12 and 13).
+ *
+ * NOTE. This uses SPI.h, so like abstractMCP23017, it uses the .cpp.h bodge (see abstractMCP23017.cpp.h).
+ * Include abstractMCP23S17.cpp.h (rather than this file) in your sketch :
+ *
+ *     #include <SPI.h>
+ *     #include <abstractIO.h>
+ *     #include <abstractMCP23S17.cpp.h>
+ */
+
+#ifndef abstractMCP23S17_h
+#define abstractMCP23S17_h
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "abstractMCP23017.h"
+
+class MCP23S17Bus;
+
+/*
+ * An ExpanderBus for MCP23S17s which share the same chip select pin.
+ * Each read or write is a single SPI transaction : the opcode (which includes the chip's address), the register,
+ * and then the data (using the chip's auto-increment, the same as over I2C).
+ */
+class MCP23S17Bus : public ExpanderBus
+{
+  protected :
+    byte csPin;
+    SPISettings settings;
+    boolean started; // SPI.begin() is called the first time the bus is used.
+
+  public :
+    /*
+     * csPin : Connected to the CS pin of each of the chips.
+     * clock : The maximum SPI clock speed in Hz. The MCP23S17 can go up to 10MHz (an Uno's fastest is 8MHz).
+     */
+    MCP23S17Bus( byte csPin, unsigned long clock = 10000000 );
+
+    virtual void begin();
+
+    virtual void readRegisters( byte address, byte registerID, byte count, byte* values );
+    virtual void writeRegisters( byte address, byte registerID, byte count, byte* values );
+};
+
+#endif
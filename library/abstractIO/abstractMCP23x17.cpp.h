@@ -0,0 +1,510 @@
+/*
+ * The parts of the MCP23017 implementation which are the same for the I2C version (MCP23017) and the
+ * SPI version (MCP23S17). Only the ExpanderBus differs.
+ *
+ * Do not include this directly, include abstractMCP23017.cpp.h and/or abstractMCP23S17.cpp.h instead.
+ */
+
+#ifndef abstractMCP23x17_cpp_h
+#define abstractMCP23x17_cpp_h
+
+#include <abstractMCP23017.h>
+
+#define MCP23017_BASE_ADDRESS 0x20 // The base I2C address. the low 3 bits are user defined.
+
+// See page 12 of : http://ww1.microchip.com/downloads/en/DeviceDoc/20001952C.pdf
+#define MCP23017_IODIRA 0x00 // Set the direction of bank A pins (HIGH for INPUT, and LOW for OUTPUT)
+#define MCP23017_IODIRB 0x01 // Set the direction of bank B pins (HIGH for INPUT, and LOW for OUTPUT)
+
+#define MCP23017_IPOLA  0x02 // Input polarity. A high bit reverses the logic when reading an input.
+#define MCP23017_IPOLB  0x03 // So a switch with a pullup resistor will return HIGH when pressed.
+
+#define MCP23017_GPINTENA 0x04 // Interrupt-on-change enable bank A
+#define MCP23017_GPINTENB 0x05 // Interrupt-on-change enable bank B
+
+#define MCP23017_DEFVALA 0x06 // The default values to compare against (when INTCON is set).
+#define MCP23017_DEFVALB 0x07
+
+#define MCP23017_INTCONA 0x08 // Interrupt control. 1 compares against DEFVAL, 0 compares against the previous value.
+#define MCP23017_INTCONB 0x09
+
+#define MCP23017_IOCON 0x0A // Configuration (shared by both banks).
+#define MCP23017_IOCON_MIRROR 0x40 // INTA and INTB are both triggered by either bank.
+#define MCP23017_IOCON_HAEN 0x08 // MCP23S17 only. Enables the hardware address pins A0..A2.
+#define MCP23017_IOCON_ODR 0x04 // INTA and INTB are open drain outputs.
+
+#define MCP23017_GPPUA 0x0C // Enable pullup resistors on bank A
+#define MCP23017_GPPUB 0x0D // Enable pullup resistors on bank B
+
+#define MCP23017_INTFA 0x0E // Interrupt flags. Which pin(s) caused the interrupt.
+#define MCP23017_INTFB 0x0F
+
+#define MCP23017_INTCAPA 0x10 // The values of the pins when the interrupt occurred.
+#define MCP23017_INTCAPB 0x11
+
+#define MCP23017_GPIOA  0x12 // Read GPIO bank A
+#define MCP23017_GPIOB  0x13 // Read GPIO bank B
+
+#define MCP23017_OLATA  0x14 // Output Latch bank A
+#define MCP23017_OLATB  0x15 // Output Latch bank B
+
+// EXPANDER BUS
+
+ExpanderBus::ExpanderBus()
+{
+    this->expanders = NULL;
+    this->bytes = 0;
+    this->transactions = 0;
+    this->frameBytes = 0;
+    this->frameTransactions = 0;
+    this->iocon = 0;
+    this->prefetch = false;
+}
+
+void ExpanderBus::add( BufferedMCP23017* expander )
+{
+    expander->nextOnBus = this->expanders;
+    this->expanders = expander;
+}
+
+void ExpanderBus::beginFrame()
+{
+    this->bytes = 0;
+    this->transactions = 0;
+
+    for ( BufferedMCP23017* expander = this->expanders; expander; expander = expander->nextOnBus ) {
+        expander->fetch();
+    }
+}
+
+void ExpanderBus::endFrame()
+{
+    for ( BufferedMCP23017* expander = this->expanders; expander; expander = expander->nextOnBus ) {
+        expander->flush();
+    }
+    if ( this->prefetch ) {
+        for ( BufferedMCP23017* expander = this->expanders; expander; expander = expander->nextOnBus ) {
+            expander->prefetch();
+        }
+    }
+
+    this->frameBytes = this->bytes;
+    this->frameTransactions = this->transactions;
+}
+
+void ExpanderBus::startReadRegisters( byte i2cAddress, byte registerID, byte count, byte* values )
+{
+    this->readRegisters( i2cAddress, registerID, count, values );
+}
+
+void ExpanderBus::startWriteRegisters( byte i2cAddress, byte registerID, byte count, byte* values )
+{
+    this->writeRegisters( i2cAddress, registerID, count, values );
+}
+
+boolean ExpanderBus::busy()
+{
+    return false;
+}
+
+void ExpanderBus::wait()
+{
+    while ( this->busy() ) {
+    }
+}
+
+// ABSTRACT MCP23017
+
+AbstractMCP23017::AbstractMCP23017( byte address, ExpanderBus* bus )
+{
+    this->bus = bus;
+    this->i2cAddress = MCP23017_BASE_ADDRESS | address;
+
+    // The power-on defaults : All pins are inputs, and everything else is zero.
+    for ( byte i = 0; i < MCP23017_CONFIG_REGISTERS; i ++ ) {
+        this->config[i] = 0;
+    }
+    this->config[ MCP23017_IODIRA ] = 0xff;
+    this->config[ MCP23017_IODIRB ] = 0xff;
+    this->olat = 0;
+
+    this->config[ MCP23017_IOCON ] = bus->iocon;
+    this->config[ MCP23017_IOCON + 1 ] = bus->iocon;
+
+    this->started = false;
+    this->batching = false;
+    this->firstDirty = MCP23017_CONFIG_REGISTERS;
+    this->lastDirty = 0;
+}
+
+void AbstractMCP23017::begin()
+{
+    if ( ! this->started ) {
+        this->started = true;
+        this->bus->begin();
+
+        // The chip may not have been reset, so write all of the registers, rather than relying on the defaults.
+        this->bus->writeRegisters( this->i2cAddress, MCP23017_IODIRA, MCP23017_CONFIG_REGISTERS, this->config );
+        byte values[2] = { (byte) (this->olat & 0xff), (byte) (this->olat >> 8) };
+        this->bus->writeRegisters( this->i2cAddress, MCP23017_OLATA, 2, values );
+
+        this->firstDirty = MCP23017_CONFIG_REGISTERS;
+        this->lastDirty = 0;
+    }
+}
+
+void AbstractMCP23017::beginConfiguration()
+{
+    this->batching = true;
+}
+
+void AbstractMCP23017::endConfiguration()
+{
+    this->batching = false;
+    this->flushConfiguration();
+}
+
+void AbstractMCP23017::flushConfiguration()
+{
+    if ( this->batching ) {
+        return;
+    }
+    if ( ! this->started ) {
+        this->begin(); // Writes all of the config registers.
+    } else if ( this->firstDirty <= this->lastDirty ) {
+        this->bus->writeRegisters( this->i2cAddress, this->firstDirty, this->lastDirty - this->firstDirty + 1, this->config + this->firstDirty );
+    }
+    this->firstDirty = MCP23017_CONFIG_REGISTERS;
+    this->lastDirty = 0;
+}
+
+byte AbstractMCP23017::readRegister( byte registerID )
+{
+    this->begin();
+    byte a;
+    this->bus->readRegisters( this->i2cAddress, registerID, 1, &a );
+    return a;
+}
+
+unsigned int AbstractMCP23017::readRegister2( byte registerID )
+{
+    this->begin();
+    byte values[2];
+    this->bus->readRegisters( this->i2cAddress, registerID, 2, values );
+    return (values[1] << 8) | values[0];
+}
+
+void AbstractMCP23017::writeRegister( byte registerID, byte data )
+{
+    this->writeRegisters( registerID, 1, &data );
+}
+
+void AbstractMCP23017::writeRegister2( byte registerID, unsigned int data )
+{
+    byte values[2] = { (byte) (data & 0xff), (byte) (data >> 8) };
+    this->writeRegisters( registerID, 2, values );
+}
+
+void AbstractMCP23017::writeRegisters( byte registerID, byte count, byte* values )
+{
+    // Keep the shadow copies up to date.
+    boolean configOnly = true;
+    for ( byte i = 0; i < count; i ++ ) {
+        byte r = registerID + i;
+        if ( r < MCP23017_CONFIG_REGISTERS ) {
+            if ( r == MCP23017_IOCON || r == MCP23017_IOCON + 1 ) {
+                // IOCONA and IOCONB are the same register, so keep both copies the same.
+                this->config[ MCP23017_IOCON ] = values[i];
+                this->config[ MCP23017_IOCON + 1 ] = values[i];
+            } else {
+                this->config[r] = values[i];
+            }
+            if ( r < this->firstDirty ) {
+                this->firstDirty = r;
+            }
+            if ( r > this->lastDirty ) {
+                this->lastDirty = r;
+            }
+        } else {
+            configOnly = false;
+            if ( r == MCP23017_GPIOA || r == MCP23017_OLATA ) {
+                this->olat = (this->olat & 0xff00) | values[i];
+            } else if ( r == MCP23017_GPIOB || r == MCP23017_OLATB ) {
+                this->olat = (this->olat & 0x00ff) | (values[i] << 8);
+            }
+        }
+    }
+
+    if ( configOnly ) {
+        this->flushConfiguration();
+    } else if ( ! this->started ) {
+        this->begin(); // Writes the shadow registers, which include this change.
+    } else {
+        this->bus->writeRegisters( this->i2cAddress, registerID, count, values );
+    }
+}
+
+unsigned int AbstractMCP23017::readBoth()
+{
+    return this->readRegister2( MCP23017_GPIOA );
+}
+
+byte AbstractMCP23017::readBank( boolean bankA )
+{
+    return this->readRegister( bankA ? MCP23017_GPIOA : MCP23017_GPIOB );
+}
+
+void AbstractMCP23017::writeBoth( unsigned int data )
+{
+    this->writeRegister2( MCP23017_GPIOA, data );
+}
+
+void AbstractMCP23017::writeBank( boolean bankA, byte data )
+{
+    this->writeRegister( bankA ? MCP23017_GPIOA : MCP23017_GPIOB, data );
+}
+
+void AbstractMCP23017::setRegisterBit( byte registerID, byte bit, boolean value )
+{
+    byte pins;
+    if ( registerID < MCP23017_CONFIG_REGISTERS ) {
+        pins = this->config[ registerID ];
+    } else if ( registerID == MCP23017_OLATA || registerID == MCP23017_OLATB ) {
+        pins = registerID == MCP23017_OLATA ? this->olat & 0xff : this->olat >> 8;
+    } else {
+        pins = this->readRegister( registerID );
+    }
+
+    byte old = pins;
+    byte mask = 1 << bit;
+    if (value) {
+        pins |= mask;
+    } else {
+        pins &= ~mask;
+    }
+    if ( pins != old ) {
+        this->writeRegister( registerID, pins );
+    }
+}
+     
+void AbstractMCP23017::pinMode( byte pinNumber, byte mode )
+{
+    this->setRegisterBit( pinNumber < 8 ? MCP23017_IODIRA : MCP23017_IODIRB, pinNumber & 7, mode != OUTPUT );
+    if ( mode != OUTPUT ) {
+        this->setRegisterBit( pinNumber < 8 ? MCP23017_GPPUA : MCP23017_GPPUB, pinNumber & 7, mode == INPUT_PULLUP );
+    }
+}
+
+void AbstractMCP23017::inputPolarity( byte pinNumber, boolean value )
+{
+    this->setRegisterBit( pinNumber < 8 ? MCP23017_IPOLA : MCP23017_IPOLB, pinNumber & 7, value );
+}
+
+void AbstractMCP23017::interruptMode( byte pinNumber, byte mode )
+{
+    byte bit = pinNumber & 7;
+    boolean bankA = pinNumber < 8;
+    if ( mode != MCP23017_NO_INTERRUPT ) {
+        this->setRegisterBit( bankA ? MCP23017_INTCONA : MCP23017_INTCONB, bit, mode != MCP23017_INTERRUPT_CHANGE );
+        if ( mode != MCP23017_INTERRUPT_CHANGE ) {
+            // An interrupt occurs when the pin differs from DEFVAL.
+            this->setRegisterBit( bankA ? MCP23017_DEFVALA : MCP23017_DEFVALB, bit, mode == MCP23017_INTERRUPT_LOW );
+        }
+    }
+    this->setRegisterBit( bankA ? MCP23017_GPINTENA : MCP23017_GPINTENB, bit, mode != MCP23017_NO_INTERRUPT );
+}
+
+Input* AbstractMCP23017::createInput( byte pinNumber, boolean trueReading, boolean enablePullUp ) 
+{
+    return ABSTRACT_NEW( MCP23017Input )( this, pinNumber, trueReading, enablePullUp );
+}
+
+Output* AbstractMCP23017::createOutput( byte pinNumber) 
+{
+    return ABSTRACT_NEW( MCP23017Output )( this, pinNumber );
+}
+
+// MCP23017
+
+MCP23017::MCP23017( byte i2cAddress, ExpanderBus* bus ) : AbstractMCP23017( i2cAddress, bus )
+{
+}
+
+boolean MCP23017::digitalRead( byte pinNumber )
+{
+    // Read either bank A or B.
+    byte pins = this->readBank( pinNumber < 8 );
+    // AND the results with a mask for the required pin number
+    return (pins & (1 << (pinNumber & 7))) != 0;
+}
+
+void MCP23017::digitalWrite( byte pinNumber, boolean value )
+{
+    this->setRegisterBit( pinNumber < 8 ? MCP23017_OLATA : MCP23017_OLATB, pinNumber & 7, value );
+}
+
+// BUFFERED MCP23017
+
+BufferedMCP23017::BufferedMCP23017( byte i2cAddress, ExpanderBus* bus ) : AbstractMCP23017( i2cAddress, bus )
+{
+    this->readRequired = true;
+    this->inputBuffer = 0;
+    this->outputBuffer = 0;
+    this->oldOutputBuffer = 0; // The output latches are set to zero when the chip is first used.
+    this->interruptPin = MCP23017_NO_INTERRUPT;
+    this->pending = true;
+    this->fetchedCount = 0;
+    this->prefetched = false;
+    bus->add( this );
+}
+
+void BufferedMCP23017::read()
+{
+    readRequired = true;
+}
+
+void BufferedMCP23017::fetch()
+{
+    if ( this->prefetched ) {
+        this->bus->wait();
+        this->prefetched = false;
+    } else {
+        this->startFetch( false );
+    }
+    this->useFetched();
+    this->readRequired = false;
+}
+
+void BufferedMCP23017::prefetch()
+{
+    if ( ! this->prefetched ) {
+        this->startFetch( true );
+        this->prefetched = true;
+    }
+}
+
+void BufferedMCP23017::startFetch( boolean async )
+{
+    this->begin();
+    if ( this->interruptPin != MCP23017_NO_INTERRUPT && ! this->pending ) {
+        IO_PROFILE( digitalReads, 1 ); // The interrupt pin, below.
+    }
+    if ( this->interruptPin == MCP23017_NO_INTERRUPT ) {
+        this->fetchedCount = 2; // GPIOA and GPIOB
+
+    } else if ( this->pending || ::digitalRead( this->interruptPin ) == LOW ) {
+        // Read INTFA, INTFB, INTCAPA, INTCAPB, GPIOA and GPIOB in one go. This also clears the interrupt.
+        this->fetchedCount = 6;
+
+    } else {
+        this->fetchedCount = 0;
+        return;
+    }
+
+    byte registerID = this->fetchedCount == 2 ? MCP23017_GPIOA : MCP23017_INTFA;
+    if ( async ) {
+        this->bus->startReadRegisters( this->i2cAddress, registerID, this->fetchedCount, this->fetched );
+    } else {
+        this->bus->readRegisters( this->i2cAddress, registerID, this->fetchedCount, this->fetched );
+    }
+}
+
+void BufferedMCP23017::useFetched()
+{
+    if ( this->fetchedCount == 2 ) {
+        this->inputBuffer = (this->fetched[1] << 8) | this->fetched[0];
+
+    } else if ( this->fetchedCount == 6 ) {
+        unsigned int flags = (this->fetched[1] << 8) | this->fetched[0];
+        unsigned int captured = (this->fetched[3] << 8) | this->fetched[2];
+        unsigned int current = (this->fetched[5] << 8) | this->fetched[4];
+
+        // Use the captured value for the pin(s) which caused the interrupt, so short pulses aren't lost.
+        this->inputBuffer = (current & ~flags) | (captured & flags);
+        // If a pin has changed since it was captured, then its current value is reported by the next fetch().
+        this->pending = ((captured ^ current) & flags) != 0;
+    }
+}
+
+void BufferedMCP23017::useInterrupt( byte arduinoPin, unsigned int pins )
+{
+    this->writeRegister( MCP23017_IOCON, this->config[ MCP23017_IOCON ] | MCP23017_IOCON_MIRROR | MCP23017_IOCON_ODR );
+    unsigned int inputs = (this->config[ MCP23017_IODIRB ] << 8) | this->config[ MCP23017_IODIRA ];
+    unsigned int enabled = (this->config[ MCP23017_GPINTENB ] << 8) | this->config[ MCP23017_GPINTENA ];
+    unsigned int intcon = (this->config[ MCP23017_INTCONB ] << 8) | this->config[ MCP23017_INTCONA ];
+    // Only the newly enabled pins are set to compare against their previous values (i.e. interrupt on change).
+    unsigned int newPins = pins & inputs & ~enabled;
+    this->writeRegister2( MCP23017_INTCONA, intcon & ~newPins );
+    this->writeRegister2( MCP23017_GPINTENA, enabled | newPins );
+
+    ::pinMode( arduinoPin, INPUT_PULLUP ); // The interrupt pins are open drain, and active LOW.
+    this->interruptPin = arduinoPin;
+    this->pending = true;
+}
+
+void BufferedMCP23017::flush()
+{
+    if ( this->oldOutputBuffer != this->outputBuffer ) {
+        this->olat = this->outputBuffer;
+        if ( ! this->started ) {
+            this->begin(); // Writes olat along with the config registers.
+        } else {
+            // Doesn't wait for the write to finish (on a bus which supports it, such as AsyncI2CBus).
+            byte values[2] = { (byte) (this->olat & 0xff), (byte) (this->olat >> 8) };
+            this->bus->startWriteRegisters( this->i2cAddress, MCP23017_OLATA, 2, values );
+        }
+        this->oldOutputBuffer = this->outputBuffer;
+    }
+}
+    
+void BufferedMCP23017::digitalWrite( byte pinNumber, boolean value )
+{    
+    unsigned int mask = 1 << pinNumber;
+    if (value) {
+        this->outputBuffer |= mask;
+    } else {
+        this->outputBuffer &= ~mask;
+    }
+}
+
+boolean BufferedMCP23017::digitalRead( byte pinNumber )
+{
+    if (this->readRequired) {
+        this->fetch();
+    }
+
+    return (this->inputBuffer & (1 << pinNumber)) != 0;
+}
+
+// MCP23017 INPUT
+
+MCP23017Input::MCP23017Input( AbstractMCP23017* mcp23017, byte pinNumber, boolean trueReading, boolean enablePullUp )
+{
+    this->mcp23017 = mcp23017;
+    this->pinNumber = pinNumber;
+    this->mcp23017->pinMode( pinNumber, enablePullUp ? INPUT_PULLUP : INPUT );
+    this->mcp23017->inputPolarity( pinNumber, ! trueReading );
+}
+
+boolean MCP23017Input::get()
+{
+    return this->mcp23017->digitalRead( this->pinNumber );
+}
+
+// MCP23017 OUTPUT
+
+MCP23017Output::MCP23017Output( AbstractMCP23017* mcp23017, byte pinNumber )
+{
+    this->mcp23017 = mcp23017;
+    this->pinNumber = pinNumber;
+    this->mcp23017->pinMode( pinNumber, OUTPUT );
+}
+
+void MCP23017Output::set( boolean value )
+{
+    this->mcp23017->digitalWrite( this->pinNumber, value );
+}
+
+#endif
+
+// END
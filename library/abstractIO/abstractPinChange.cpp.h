@@ -0,0 +1,151 @@
+// See abstractPinChange.h for why this has a weird .cpp.h suffix.
+
+// Unlike the other .cpp.h files, this is guarded, because abstractButtonEvents.cpp.h also includes it.
+#ifndef abstractPinChange_cpp_h
+#define abstractPinChange_cpp_h
+
+#include <abstractPinChange.h>
+
+#ifndef ABSTRACT_PORT_REGISTERS
+#error "abstractPinChange is only supported on AVR based boards"
+#endif
+
+// PIN CHANGE
+
+#define ABSTRACT_PIN_CHANGE_GROUPS 4 // Most chips have 3 groups (PCINT0..2), a few have 4.
+
+// A linked list of listeners for each group.
+PinChangeListener* abstractPinChangeListeners[ ABSTRACT_PIN_CHANGE_GROUPS ];
+
+PinChangeListener::PinChangeListener()
+{
+    this->nextPinChangeListener = NULL;
+    this->pinChangeGroup = ABSTRACT_NO_PIN_CHANGE_GROUP;
+}
+
+boolean attachPinChange( byte pin, PinChangeListener* listener )
+{
+    volatile uint8_t* pcicr = digitalPinToPCICR( pin );
+    if ( pcicr == 0 ) {
+        IO_DEBUG2( "Pin change interrupts not supported on pin", pin );
+        return false;
+    }
+    byte group = digitalPinToPCICRbit( pin );
+
+    // The listener has only one link, so it can only be in one group's list. Re-linking it would corrupt the other list.
+    if ( listener->pinChangeGroup != ABSTRACT_NO_PIN_CHANGE_GROUP && listener->pinChangeGroup != group ) {
+        IO_DEBUG3( "Pin change listener is already attached to another group", pin, listener->pinChangeGroup );
+        return false;
+    }
+
+    uint8_t oldSREG = SREG;
+    cli();
+
+    // The same listener may be attached to several pins in the same group, but it must only be in the list once.
+    if ( listener->pinChangeGroup == ABSTRACT_NO_PIN_CHANGE_GROUP ) {
+        listener->nextPinChangeListener = abstractPinChangeListeners[ group ];
+        listener->pinChangeGroup = group;
+        abstractPinChangeListeners[ group ] = listener;
+    }
+
+    *digitalPinToPCMSK( pin ) |= 1 << digitalPinToPCMSKbit( pin );
+    *pcicr |= 1 << group;
+
+    SREG = oldSREG;
+    return true;
+}
+
+static inline void abstractPinChanged( byte group )
+{
+    for ( PinChangeListener* listener = abstractPinChangeListeners[ group ]; listener != NULL; listener = listener->nextPinChangeListener ) {
+        listener->pinsChanged();
+    }
+}
+
+#ifdef PCINT0_vect
+ISR( PCINT0_vect ) { abstractPinChanged( 0 ); }
+#endif
+#ifdef PCINT1_vect
+ISR( PCINT1_vect ) { abstractPinChanged( 1 ); }
+#endif
+#ifdef PCINT2_vect
+ISR( PCINT2_vect ) { abstractPinChanged( 2 ); }
+#endif
+#ifdef PCINT3_vect
+ISR( PCINT3_vect ) { abstractPinChanged( 3 ); }
+#endif
+
+PinChangeForwarder::PinChangeForwarder( PinChangeListener* target )
+{
+    this->target = target;
+}
+
+void PinChangeForwarder::pinsChanged()
+{
+    this->target->pinsChanged();
+}
+
+// INTERRUPT ROTARY ENCODER
+
+// Indexed by (previous state << 2) | new state. Invalid transitions (both pins changing) are ignored.
+// The direction is the same as SimpleRotaryEncoder.
+static const int8_t abstractQuadratureTable[16] = { 0, 1, -1, 0, -1, 0, 0, 1, 1, 0, 0, -1, 0, -1, 1, 0 };
+
+InterruptRotaryEncoder::InterruptRotaryEncoder( byte pinA, byte pinB, byte beatsPerDetent )
+  : forwarderB( this )
+{
+    this->registerA = portInputRegister( digitalPinToPort( pinA ) );
+    this->registerB = portInputRegister( digitalPinToPort( pinB ) );
+    this->maskA = digitalPinToBitMask( pinA );
+    this->maskB = digitalPinToBitMask( pinB );
+    this->beatsPerDetent = beatsPerDetent;
+    this->val = 0;
+
+    pinMode( pinA, INPUT_PULLUP );
+    pinMode( pinB, INPUT_PULLUP );
+
+    this->state = this->readState();
+
+    attachPinChange( pinA, this );
+    if ( digitalPinToPCICRbit( pinB ) == digitalPinToPCICRbit( pinA ) ) {
+        attachPinChange( pinB, this );
+    } else {
+        attachPinChange( pinB, &this->forwarderB );
+    }
+}
+
+byte InterruptRotaryEncoder::readState()
+{
+    return ( (*this->registerA & this->maskA) ? 2 : 0 ) | ( (*this->registerB & this->maskB) ? 1 : 0 );
+}
+
+void InterruptRotaryEncoder::pinsChanged()
+{
+    byte newState = this->readState();
+    if ( newState != this->state ) {
+        this->val += abstractQuadratureTable[ (this->state << 2) | newState ];
+        this->state = newState;
+    }
+}
+
+int InterruptRotaryEncoder::get()
+{
+    uint8_t oldSREG = SREG;
+    cli();
+    int value = this->val;
+    SREG = oldSREG;
+
+    return value / this->beatsPerDetent;
+}
+
+void InterruptRotaryEncoder::set( int value )
+{
+    uint8_t oldSREG = SREG;
+    cli();
+    this->val = value * this->beatsPerDetent;
+    SREG = oldSREG;
+}
+
+// END
+
+#endif
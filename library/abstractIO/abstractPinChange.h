@@ -0,0 +1,108 @@
+/*
+ * Classes which use "pin change" interrupts, so that they don't miss changes, even when loop() is slow.
+ *
+ * AVR chips have a pin change interrupt for each group of pins (usually one group per port), so any pin can be
+ * used, and many objects can share the same interrupt.
+ *
+ * NOTE. This defines the PCINTx interrupt handlers, which would clash with other libraries which also use them,
+ * such as SoftwareSerial. So like abstractMCP23017, this uses the .cpp.h bodge (see abstractMCP23017.cpp.h),
+ * and is only compiled if your sketch includes it :
+ *
+ *     #include <abstractIO.h>
+ *     #include <abstractRotaryEncoder.h>
+ *     #include <abstractPinChange.cpp.h>
+ *
+ * Only include abstractPinChange.cpp.h once.
+ * This is only supported on AVR based boards (Uno, Nano, Mega etc).
+ */
+
+#ifndef abstractPinChange_h
+#define abstractPinChange_h
+
+#include <Arduino.h>
+#include "abstractIO.h"
+#include "abstractRotaryEncoder.h"
+
+class PinChangeListener;
+class PinChangeForwarder;
+class InterruptRotaryEncoder;
+
+/*
+ * Anything which wants to know when a pin changes.
+ * pinsChanged() is called from within the interrupt, so keep it short, and any data it changes must be volatile.
+ * Note, pinsChanged() is called when ANY pin in the same group changes, so it should check the pins it is interested in.
+ *
+ * A listener is a node in the linked list of ONE group, so it can only be attached to pins in that group.
+ * To listen to pins in other groups as well, use a PinChangeForwarder for each extra group.
+ */
+class PinChangeListener
+{
+  public :
+    PinChangeListener();
+
+    PinChangeListener* nextPinChangeListener; // The listeners are held in a linked list for each group.
+    byte pinChangeGroup; // The group whose list this is in, or ABSTRACT_NO_PIN_CHANGE_GROUP.
+
+    virtual void pinsChanged() = 0;
+};
+
+#define ABSTRACT_NO_PIN_CHANGE_GROUP 0xff
+
+/*
+ * Passes pinsChanged() on to another listener, so that it can listen to pins in more than one group.
+ */
+class PinChangeForwarder : public PinChangeListener
+{
+  public :
+    PinChangeForwarder( PinChangeListener* target );
+
+    virtual void pinsChanged();
+
+  protected :
+    PinChangeListener* target;
+};
+
+/*
+ * Enables the pin change interrupt for the given pin, and calls listener->pinsChanged() whenever it changes.
+ * The same listener can be attached to more than one pin, as long as they are all in the same group.
+ * Returns false if the pin does not support pin change interrupts, or is in a different group to the
+ * listener's other pins.
+ */
+extern boolean attachPinChange( byte pin, PinChangeListener* listener );
+
+/*
+ * A rotary encoder, which uses pin change interrupts on both pins to decode every transition
+ * (known as 4x quadrature decoding), so that no steps are missed, however slow your loop() is.
+ * Any two pins can be used (even in different groups), and any number of encoders can share the same
+ * pin change interrupt.
+ *
+ * The count is updated from within the interrupt, and get() and set() briefly disable interrupts
+ * while they read or write it.
+ */
+class InterruptRotaryEncoder : public RotaryEncoder, public PinChangeListener
+{
+  public :
+    // Most encoders have 4 transitions per "click" (detent), but some have 2, or even 1.
+    InterruptRotaryEncoder( byte pinA, byte pinB, byte beatsPerDetent = 4 );
+
+    virtual int get();
+    virtual void set( int value );
+
+    virtual void pinsChanged();
+
+  protected :
+    volatile uint8_t* registerA;
+    volatile uint8_t* registerB;
+    byte maskA;
+    byte maskB;
+    byte beatsPerDetent;
+
+    byte state; // The previous state of pins A and B (A is bit 1, B is bit 0).
+    volatile int val;
+
+    PinChangeForwarder forwarderB; // Listens to pin B when it is in a different group to pin A.
+
+    byte readState();
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "abstractPort.h"
+
+// PORT INPUT BANK
+
+PortInputBank::PortInputBank()
+{
+    this->portCount = 0;
+#ifndef ABSTRACT_PORT_REGISTERS
+    this->pinCount = 0;
+#endif
+}
+
+void PortInputBank::read()
+{
+#ifdef ABSTRACT_PORT_REGISTERS
+    IO_PROFILE( digitalReads, this->portCount );
+    for ( byte i = 0; i < this->portCount; i ++ ) {
+        this->values[i] = *this->registers[i];
+    }
+#else
+    for ( byte i = 0; i < this->portCount; i ++ ) {
+        this->values[i] = 0;
+    }
+    IO_PROFILE( digitalReads, this->pinCount );
+    for ( byte i = 0; i < this->pinCount; i ++ ) {
+        if ( digitalRead( this->pins[i] ) ) {
+            this->values[i >> 3] |= 1 << (i & 7);
+        }
+    }
+#endif
+}
+
+boolean PortInputBank::allocate( byte pin, byte* slot, byte* mask )
+{
+#ifdef ABSTRACT_PORT_REGISTERS
+    volatile uint8_t* reg = portInputRegister( digitalPinToPort( pin ) );
+    *mask = digitalPinToBitMask( pin );
+
+    for ( byte i = 0; i < this->portCount; i ++ ) {
+        if ( this->registers[i] == reg ) {
+            *slot = i;
+            return true;
+        }
+    }
+    if ( this->portCount >= ABSTRACT_PORT_BANK_SIZE ) {
+        return false;
+    }
+    this->registers[ this->portCount ] = reg;
+    *slot = this->portCount ++;
+    return true;
+#else
+    for ( byte i = 0; i < this->pinCount; i ++ ) {
+        if ( this->pins[i] == pin ) {
+            *slot = i >> 3;
+            *mask = 1 << (i & 7);
+            return true;
+        }
+    }
+    if ( this->pinCount >= ABSTRACT_PORT_BANK_SIZE * 8 ) {
+        return false;
+    }
+    *slot = this->pinCount >> 3;
+    *mask = 1 << (this->pinCount & 7);
+    this->pins[ this->pinCount ++ ] = pin;
+    this->portCount = *slot + 1;
+    return true;
+#endif
+}
+
+Input* PortInputBank::createInput( byte pin, boolean trueReading, boolean enablePullup )
+{
+    byte slot;
+    byte mask;
+    if ( ! this->allocate( pin, &slot, &mask ) ) {
+        IO_DEBUG2( "PortInputBank full. Using a SimpleInput for pin", pin );
+        return ABSTRACT_NEW( SimpleInput )( pin, trueReading, enablePullup );
+    }
+
+    pinMode( pin, enablePullup ? INPUT_PULLUP : INPUT );
+    this->read(); // So that the new input has a valid value, even before the next call to read().
+
+    return ABSTRACT_NEW( PortInput )( this, slot, mask, trueReading );
+}
+
+// PORT INPUT
+
+PortInput::PortInput( PortInputBank* bank, byte slot, byte mask, byte trueReading )
+{
+    this->bank = bank;
+    this->slot = slot;
+    this->mask = mask;
+    this->trueReading = trueReading;
+}
+
+boolean PortInput::get()
+{
+    return ( (this->bank->values[ this->slot ] & this->mask) ? HIGH : LOW ) == this->trueReading;
+}
+
+// END
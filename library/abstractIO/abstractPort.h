@@ -0,0 +1,256 @@
+/*
+ * Reading lots of pins using digitalRead is slow, because each call has to look up which port the pin belongs to,
+ * check if the pin has a PWM timer attached, and then finally read the port's register.
+ * If you have 20 switches, then that work is done 20 times every loop.
+ *
+ * A PortInputBank reads each of the Arduino's ports just once (by calling read() at the top of your loop()),
+ * and the PortInput objects that it creates then read their value from that snapshot.
+ *
+ * On AVR based boards (Uno, Nano, Mega etc.) the PINx registers are read directly, 8 pins at a time.
+ * On other boards, read() falls back to calling digitalRead for each pin, which is no quicker than SimpleInput,
+ * but still gives the same "snapshot" behaviour, so your code will behave the same on all boards.
+ *
+ * Example :
+ *     PortInputBank bank;
+ *     Input* a = bank.createInput( 4 );
+ *     Button* b = bank.createInput( 5 )->button();
+ *
+ *     void loop() {
+ *         bank.read(); // Once per loop
+ *         if ( a->get() ) ...
+ *     }
+ */
+
+#ifndef abstractPort_h
+#define abstractPort_h
+
+#include <Arduino.h>
+#include "abstractIO.h"
+
+// The maximum number of ports (of 8 pins) which a single PortInputBank can read.
+// An Uno/Nano only has 3 ports (B, C and D), but a Mega has 11, so increase this if you need to.
+#ifndef ABSTRACT_PORT_BANK_SIZE
+#define ABSTRACT_PORT_BANK_SIZE 4
+#endif
+
+class PortInputBank;
+class PortInput;
+template <byte PIN, byte TRUE_READING, boolean PULLUP> class FastInput;
+template <byte PIN, boolean INVERTED> class FastOutput;
+template <class FAST> class FastInputAdapter;
+template <class FAST> class FastOutputAdapter;
+
+class PortInputBank
+{
+  friend class PortInput;
+
+  protected :
+    byte portCount;
+    byte values[ ABSTRACT_PORT_BANK_SIZE ]; // The snapshot taken by read(). One byte per port.
+
+#ifdef ABSTRACT_PORT_REGISTERS
+    volatile uint8_t* registers[ ABSTRACT_PORT_BANK_SIZE ]; // The PINx register for each port.
+#else
+    byte pins[ ABSTRACT_PORT_BANK_SIZE * 8 ]; // Pins are grouped into "virtual" ports of 8 pins.
+    byte pinCount;
+#endif
+
+  public :
+    PortInputBank();
+
+    /*
+     * Takes a snapshot of all the ports used by this bank's inputs. Call this once at the top of your loop().
+     */
+    void read();
+
+    /*
+     * Creates an Input, which behaves just like SimpleInput (the parameters are the same), but reads its value
+     * from the snapshot taken by read().
+     * If the bank is already full (see ABSTRACT_PORT_BANK_SIZE), then a SimpleInput is returned instead.
+     */
+    Input* createInput( byte pin, boolean trueReading = LOW /* or HIGH */, boolean enablePullup = true );
+
+  protected :
+    // Finds (or adds) the slot for the given pin, and its bit mask within that slot.
+    // Returns false if there is no room left.
+    boolean allocate( byte pin, byte* slot, byte* mask );
+};
+
+/*
+ * An Input which reads its value from a PortInputBank's snapshot. Create these via PortInputBank::createInput.
+ */
+class PortInput : public Input
+{
+  protected :
+    PortInputBank* bank;
+    byte slot;
+    byte mask;
+    byte trueReading;
+
+  public :
+    PortInput( PortInputBank* bank, byte slot, byte mask, byte trueReading );
+
+    virtual boolean get();
+};
+
+/*
+ * On an Uno or Nano (ATmega328P and ATmega168), the port and bit of each pin is known at compile time,
+ * so FastInput and FastOutput compile down to a single instruction (sbis/sbic, sbi/cbi).
+ * On other AVR boards, the register is looked up once in the constructor (much like ABSTRACT_FAST_PINS),
+ * and on non-AVR boards, digitalRead and digitalWrite are used.
+ */
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__) || defined(__AVR_ATmega168P__)
+#define ABSTRACT_PIN_MAP
+// Pins 0..7 are PORTD, 8..13 are PORTB and 14..19 (A0..A5) are PORTC.
+#define ABSTRACT_PIN_REGISTER( pin, D, B, C ) ( (pin) < 8 ? D : (pin) < 14 ? B : C )
+#define ABSTRACT_PIN_MASK( pin ) ( 1 << ( (pin) < 8 ? (pin) : (pin) < 14 ? (pin) - 8 : (pin) - 14 ) )
+#endif
+
+/*
+ * A digital input, like SimpleInput, but the pin, trueReading and pullup are template parameters, and
+ * get() is NOT virtual, so the compiler can inline it.
+ * Use these for the "hot" pins, which are read many times per loop().
+ *
+ *     FastInput<4> switchA; // Pin 4, LOW is true, with pullup (the same as SimpleInput( 4 ))
+ *     FastInput<5, HIGH, false> sensor;
+ *
+ * If you need to pass one of these to code expecting an Input*, then use input() :
+ *     Button* button = switchA.input()->button();
+ */
+template <byte PIN, byte TRUE_READING = LOW, boolean PULLUP = true>
+class FastInput
+{
+#if defined(ABSTRACT_PORT_REGISTERS) && ! defined(ABSTRACT_PIN_MAP)
+  protected :
+    volatile uint8_t* inputRegister;
+    byte mask;
+#endif
+
+  public :
+    FastInput()
+    {
+#ifdef ABSTRACT_PIN_MAP
+        static_assert( PIN < 20, "FastInput : Pin does not exist" );
+#endif
+        pinMode( PIN, PULLUP ? INPUT_PULLUP : INPUT );
+        digitalRead( PIN ); // Turns off the pin's PWM timer (if it has one).
+#if defined(ABSTRACT_PORT_REGISTERS) && ! defined(ABSTRACT_PIN_MAP)
+        this->inputRegister = portInputRegister( digitalPinToPort( PIN ) );
+        this->mask = digitalPinToBitMask( PIN );
+#endif
+    }
+
+    inline boolean get()
+    {
+        IO_PROFILE( digitalReads, 1 );
+#if defined(ABSTRACT_PIN_MAP)
+        return ( ( ABSTRACT_PIN_REGISTER( PIN, PIND, PINB, PINC ) & ABSTRACT_PIN_MASK( PIN ) ) != 0 ) == ( TRUE_READING != LOW );
+#elif defined(ABSTRACT_PORT_REGISTERS)
+        return ( ( *this->inputRegister & this->mask ) != 0 ) == ( TRUE_READING != LOW );
+#else
+        return digitalRead( PIN ) == TRUE_READING;
+#endif
+    }
+
+    // Creates an Input (with a virtual get()) which reads this pin.
+    Input* input()
+    {
+        return ABSTRACT_NEW( FastInputAdapter<FastInput> )();
+    }
+};
+
+/*
+ * A digital output, like SimpleOutput, but the pin and polarity are template parameters, and
+ * set() is NOT virtual, so the compiler can inline it.
+ * INVERTED is the same as SimpleOutput's lowValue, i.e. when true, set( true ) outputs LOW.
+ *
+ *     FastOutput<13> led;
+ *     led.set( true );
+ *
+ * If you need to pass one of these to code expecting an Output*, then use output().
+ */
+template <byte PIN, boolean INVERTED = false>
+class FastOutput
+{
+#if defined(ABSTRACT_PORT_REGISTERS) && ! defined(ABSTRACT_PIN_MAP)
+  protected :
+    volatile uint8_t* outputRegister;
+    byte mask;
+#endif
+
+  public :
+    FastOutput()
+    {
+#ifdef ABSTRACT_PIN_MAP
+        static_assert( PIN < 20, "FastOutput : Pin does not exist" );
+#endif
+        pinMode( PIN, OUTPUT );
+        digitalRead( PIN ); // Turns off the pin's PWM timer (if it has one), without changing the output.
+#if defined(ABSTRACT_PORT_REGISTERS) && ! defined(ABSTRACT_PIN_MAP)
+        this->outputRegister = portOutputRegister( digitalPinToPort( PIN ) );
+        this->mask = digitalPinToBitMask( PIN );
+#endif
+    }
+
+    inline void set( boolean value )
+    {
+        IO_PROFILE( digitalWrites, 1 );
+#if defined(ABSTRACT_PIN_MAP)
+        // A constant register and mask compile to a single sbi or cbi, so no need to disable interrupts.
+        if ( ( value != 0 ) != INVERTED ) {
+            ABSTRACT_PIN_REGISTER( PIN, PORTD, PORTB, PORTC ) |= ABSTRACT_PIN_MASK( PIN );
+        } else {
+            ABSTRACT_PIN_REGISTER( PIN, PORTD, PORTB, PORTC ) &= ~ABSTRACT_PIN_MASK( PIN );
+        }
+#elif defined(ABSTRACT_PORT_REGISTERS)
+        uint8_t oldSREG = SREG;
+        cli();
+        if ( ( value != 0 ) != INVERTED ) {
+            *this->outputRegister |= this->mask;
+        } else {
+            *this->outputRegister &= ~this->mask;
+        }
+        SREG = oldSREG;
+#else
+        digitalWrite( PIN, ( ( value != 0 ) != INVERTED ) ? HIGH : LOW );
+#endif
+    }
+
+    // Creates an Output (with a virtual set()) which writes to this pin.
+    Output* output()
+    {
+        return ABSTRACT_NEW( FastOutputAdapter<FastOutput> )();
+    }
+};
+
+/*
+ * Adapts a FastInput (or anything else with a get() method) to the Input interface.
+ */
+template <class FAST>
+class FastInputAdapter : public Input
+{
+  public :
+    FAST fast;
+
+    virtual boolean get()
+    {
+        return this->fast.get();
+    }
+};
+
+/*
+ * Adapts a FastOutput (or anything else with a set( boolean ) method) to the Output interface.
+ */
+template <class FAST>
+class FastOutputAdapter : public Output
+{
+  public :
+    FAST fast;
+
+    virtual void set( boolean value )
+    {
+        this->fast.set( value );
+    }
+};
+
+#endif
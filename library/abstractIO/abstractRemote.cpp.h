@@ -6,8 +6,8 @@ RemoteReceiver* RemoteReceiver;
 
 RemoteReceiver::RemoteReceiver( byte pin )
 {
-    this->receiver = new IRrecv( pin );
-    this->results = new decode_results;
+    this->receiver = ABSTRACT_NEW( IRrecv )( pin );
+    this->results = ABSTRACT_NEW( decode_results );
   
     receiver->enableIRIn();
     RemoteReceiver = this; // There can only be one instance of remoteControl.
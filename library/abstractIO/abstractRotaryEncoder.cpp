@@ -4,7 +4,7 @@
 
 REAnalogInput* RotaryEncoder::createAnalogInput( int steps )
 {
-    return new REAnalogInput( this, steps );
+    return ABSTRACT_NEW( REAnalogInput )( this, steps );
 }
 
 // SIMPLE ROTARY ENCODER
@@ -24,9 +24,11 @@ SimpleRotaryEncoder::SimpleRotaryEncoder( byte pinA, byte pinB, byte beatsPerDet
 
 int SimpleRotaryEncoder::get()
 {
+    IO_PROFILE( digitalReads, 1 );
     boolean newState = digitalRead( pinA );
     
     if (this->aState != newState) {
+        IO_PROFILE( digitalReads, 1 );
         if ( digitalRead( pinB ) != newState ) {
             this->val --;
         } else {
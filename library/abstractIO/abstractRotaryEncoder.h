@@ -4,8 +4,8 @@
  * Therefore only use SimpleRotaryEncoder if your loop() is very quick, or if you don't mind when beats are missed.
  * 
  * A common solution is to use interrupts to monitor the RE, however, the Arduino only has 2 interrupts,
- * and therefore can only handle a single encoder. Alternatively a timer can also be used to monitor multiple
- * encoders. I may well use this method here later...
+ * and therefore can only handle a single encoder. Alternatively, "pin change" interrupts can be used on any pin,
+ * which is what InterruptRotaryEncoder does (see abstractPinChange.h). It can handle as many encoders as you have pins.
  * 
  * However, my long term solution involves a small PIC microcontroller to monitor the rotartary encoder
  * which the Arduino can talk to via an I2C interface. Small PICs are less than £1 from China (47p each),
@@ -29,8 +29,8 @@ class RotaryEncoder
 {
   public :
     // Returns the value of the encoder.
-    virtual int get();
-    virtual void set( int value );
+    virtual int get() = 0;
+    virtual void set( int value ) = 0;
     
     REAnalogInput* createAnalogInput( int steps );
 };
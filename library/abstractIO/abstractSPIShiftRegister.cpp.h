@@ -0,0 +1,147 @@
+/*
+ * NOTE. The weird .ccp.h file extension is a bodge to work around a problem with the Arduino IDE.
+ * See abstractMCP23017.cpp.h for details. In this case, the offending library is SPI.h rather than Wire.h.
+ */
+
+#include <abstractSPIShiftRegister.h>
+
+#include <SPI.h>
+
+// SPI SHIFT REGISTER
+
+SPIShiftRegister::SPIShiftRegister( unsigned long clock, boolean order, byte mode )
+    : ShiftRegister( MOSI, SCK, order ), settings( clock, order, mode )
+{
+    this->started = false;
+}
+
+void SPIShiftRegister::begin()
+{
+    if ( ! this->started ) {
+        SPI.begin();
+        this->started = true;
+    }
+}
+
+void SPIShiftRegister::transfer( byte byteCount, byte *values )
+{
+    this->begin();
+    if ( byteCount == 0 ) {
+        return;
+    }
+    IO_PROFILE( shiftedBytes, byteCount );
+
+    SPI.beginTransaction( this->settings );
+#if defined(__AVR__) && defined(SPDR)
+    // Rather than SPI.transfer(), which waits for each byte to be sent before returning, fetch the next byte
+    // while the previous one is being sent, and start sending it the moment the SPI hardware is ready.
+    SPDR = values[0];
+    for ( byte i = 1; i < byteCount; i ++ ) {
+        byte next = values[i];
+        while ( ! (SPSR & _BV(SPIF)) ) ;
+        SPDR = next;
+    }
+    while ( ! (SPSR & _BV(SPIF)) ) ;
+#else
+    // Note, SPI.transfer( buffer, count ) isn't used, because it overwrites the buffer with the received data.
+    for ( byte i = 0; i < byteCount; i ++ ) {
+        SPI.transfer( values[i] );
+    }
+#endif
+    SPI.endTransaction();
+}
+
+void SPIShiftRegister::output( byte value )
+{
+    this->transfer( 1, &value );
+    this->latchOutput();
+}
+
+void SPIShiftRegister::output( byte first, byte second )
+{
+    byte values[2] = { first, second };
+    this->transfer( 2, values );
+    this->latchOutput();
+}
+
+void SPIShiftRegister::output( byte byteCount, byte *values )
+{
+    this->transfer( byteCount, values );
+    this->latchOutput();
+}
+
+void SPIShiftRegister::shift( boolean value, byte n )
+{
+    byte fill = value ? 0xff : 0;
+    for ( byte i = n >> 3; i > 0; i -- ) {
+        this->transfer( 1, &fill );
+    }
+
+    n &= 7;
+    if ( n == 0 ) {
+        return;
+    }
+    // SPI cannot send less than 8 bits, so the remaining bits are bit-banged.
+    // While the SPI hardware is enabled, it drives MOSI and SCK, so it is briefly disabled.
+    this->begin();
+#if defined(__AVR__) && defined(SPCR)
+    // Not using SPI.end(), which does nothing while other devices (such as an MCP23S17Bus) are still using SPI.
+    SPI.beginTransaction( this->settings );
+    byte oldSPCR = SPCR;
+    SPCR &= ~_BV(SPE);
+    ShiftRegister::shift( value, n );
+    SPCR = oldSPCR;
+    SPI.endTransaction();
+#else
+    SPI.end();
+    ShiftRegister::shift( value, n );
+    SPI.begin();
+#endif
+}
+
+// LATCHED SPI SHIFT REGISTER
+
+LatchedSPIShiftRegister::LatchedSPIShiftRegister( byte latchPin, unsigned long clock, boolean order, byte mode )
+    : SPIShiftRegister( clock, order, mode )
+{
+    this->latchPin = latchPin;
+
+    digitalWrite( latchPin, LOW ); // Disable the output latch initially, as the data hasn't be set yet.
+    pinMode( latchPin, OUTPUT );
+}
+
+void LatchedSPIShiftRegister::latchOutput()
+{
+    IO_PROFILE( digitalWrites, 2 );
+    digitalWrite( latchPin, HIGH );
+    digitalWrite( latchPin, LOW );
+}
+
+boolean LatchedSPIShiftRegister::isLatched()
+{
+    return true;
+}
+
+// SPI PARALLEL IN SHIFT REGISTER
+
+SPIParallelInShiftRegister::SPIParallelInShiftRegister( byte loadPin, byte byteCount, unsigned long clock, boolean order, byte mode )
+    : ParallelInShiftRegister( MISO, SCK, loadPin, byteCount, order ), settings( clock, order, mode )
+{
+    this->started = false;
+}
+
+void SPIParallelInShiftRegister::transfer()
+{
+    if ( ! this->started ) {
+        SPI.begin();
+        this->started = true;
+    }
+
+    IO_PROFILE( shiftedBytes, this->byteCount );
+    SPI.beginTransaction( this->settings );
+    // Sends the old buffer's contents (which are ignored), and replaces them with the data received.
+    SPI.transfer( this->buffer, this->byteCount );
+    SPI.endTransaction();
+}
+
+// END
@@ -0,0 +1,107 @@
+/*
+ * Shift registers driven by the Arduino's SPI hardware, rather than "bit-banging" with shiftOut().
+ *
+ * shiftOut() takes roughly 100 microseconds per byte, whereas SPI can send a byte in 1 microsecond (at 8MHz),
+ * which makes a big difference when driving long chains of shift registers (such as LED panels).
+ *
+ * These are drop-in replacements for ShiftRegister and LatchedShiftRegister, so they can be used with
+ * BufferedShiftRegister, ShiftRegisterSelector and ComboSelector.
+ *
+ * SPIParallelInShiftRegister is the SPI version of ParallelInShiftRegister (for 74xx165 input chips).
+ *
+ * The data and clock pins are fixed : connect the shift register's data pin to MOSI, and its clock pin to SCK
+ * (on an Uno or Nano, these are pins 11 and 13). The latch pin can be any pin.
+ * Note that SPI makes the SS pin (pin 10 on an Uno) an output, so don't use it as an input.
+ *
+ * NOTE. This uses SPI.h, so like abstractMCP23017, it uses the .cpp.h bodge (see abstractMCP23017.cpp.h).
+ * Include abstractSPIShiftRegister.cpp.h (rather than this file) in your sketch :
+ *
+ *     #include <SPI.h>
+ *     #include <abstractIO.h>
+ *     #include <abstractSPIShiftRegister.cpp.h>
+ */
+
+#ifndef abstractSPIShiftRegister_h
+#define abstractSPIShiftRegister_h
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "abstractIO.h"
+#include "abstractShiftRegister.h"
+
+class SPIShiftRegister;
+class LatchedSPIShiftRegister;
+class SPIParallelInShiftRegister;
+
+/*
+ * An unlatched shift register, such as a 74xx164, using SPI.
+ */
+class SPIShiftRegister : public ShiftRegister
+{
+  protected :
+    SPISettings settings;
+    boolean started; // SPI.begin() is called the first time the shift register is used.
+
+  public :
+    /*
+     * clock : The maximum SPI clock speed in Hz. (An Uno's fastest is 8MHz).
+     * mode : SPI_MODE0 suits the 74xx595 and 74xx164 (data is read on the clock's rising edge).
+     */
+    SPIShiftRegister( unsigned long clock = 4000000, boolean order = MSBFIRST /* or LSBFIRST*/, byte mode = SPI_MODE0 );
+
+    virtual void output( byte value );
+    virtual void output( byte first, byte second );
+    virtual void output( byte byteCount, byte *values );
+
+    /*
+     * Whole bytes are sent using SPI, and any remaining bits are bit-banged (with the SPI hardware briefly
+     * disabled), so single bits are MUCH slower than whole bytes.
+     */
+    virtual void shift( boolean value, byte n = 1 );
+
+  protected :
+    // Calls SPI.begin() the first time the shift register is used.
+    void begin();
+
+    // Sends the bytes, without calling latchOutput().
+    void transfer( byte byteCount, byte *values );
+};
+
+/*
+ * A latched shift register, such as a 74xx595, using SPI.
+ */
+class LatchedSPIShiftRegister : public SPIShiftRegister
+{
+  protected :
+    byte latchPin;
+
+  public :
+    LatchedSPIShiftRegister( byte latchPin, unsigned long clock = 4000000, boolean order = MSBFIRST /* or LSBFIRST*/, byte mode = SPI_MODE0 );
+
+    virtual void latchOutput();
+    virtual boolean isLatched(); // true
+};
+
+/*
+ * A chain of parallel-in shift registers, such as the 74xx165, read using SPI.
+ * Connect the 74xx165's serial output (Q7) to MISO (pin 12 on an Uno), and its clock (CP) to SCK.
+ * The load pin can be any pin.
+ *
+ * Note, the 74xx165's output is always driven, so it cannot share MISO with other SPI devices
+ * (unless a tri-state buffer is added). Any 74xx595s sharing SCK and MOSI will have junk shifted into them
+ * (but not latched), so output to them after reading.
+ */
+class SPIParallelInShiftRegister : public ParallelInShiftRegister
+{
+  protected :
+    SPISettings settings;
+    boolean started; // SPI.begin() is called the first time read() is called.
+
+  public :
+    SPIParallelInShiftRegister( byte loadPin, byte byteCount, unsigned long clock = 4000000, boolean order = MSBFIRST /* or LSBFIRST*/, byte mode = SPI_MODE0 );
+
+  protected :
+    virtual void transfer();
+};
+
+#endif
@@ -0,0 +1,140 @@
+// See abstractSampler.h for why this has a weird .cpp.h suffix.
+
+#include <abstractSampler.h>
+
+#ifndef ABSTRACT_PORT_REGISTERS
+#error "abstractSampler is only supported on AVR based boards"
+#endif
+
+#define ABSTRACT_SAMPLER_MASK (ABSTRACT_SAMPLER_FRAMES - 1)
+
+// INPUT SAMPLER
+
+// The sampler which is driven by the timer interrupt. There can only be one.
+InputSampler* abstractInputSampler;
+
+ISR( TIMER0_COMPA_vect )
+{
+    abstractInputSampler->tick();
+}
+
+InputSampler::InputSampler()
+{
+    this->inputCount = 0;
+    this->overflows = 0;
+    this->divider = 1;
+    this->ticks = 0;
+    this->head = 0;
+    this->tail = 0;
+    this->latestFrame = 0;
+}
+
+void InputSampler::begin( byte divider )
+{
+    this->divider = divider;
+    this->sample(); // So that latest() is valid straight away.
+    this->tail = this->head;
+
+    abstractInputSampler = this;
+    // Timer0 is already running (for millis), so we only need to enable the interrupt.
+    // OCR0A is left alone, as it may be used by analogWrite on pin 6. Whatever its value, the interrupt fires
+    // once per cycle of the timer.
+    TIMSK0 |= _BV( OCIE0A );
+}
+
+int InputSampler::add( Input* input )
+{
+    if ( this->inputCount >= ABSTRACT_SAMPLER_INPUTS ) {
+        IO_DEBUG1( "InputSampler full" );
+        return -1;
+    }
+    this->inputs[ this->inputCount ] = input;
+    return this->inputCount ++;
+}
+
+Input* InputSampler::createInput( Input* input )
+{
+    int bit = this->add( input );
+    if ( bit < 0 ) {
+        return input;
+    }
+    return ABSTRACT_NEW( SampledInput )( this, bit );
+}
+
+void InputSampler::tick()
+{
+    if ( ++ this->ticks >= this->divider ) {
+        this->ticks = 0;
+        this->sample();
+    }
+}
+
+void InputSampler::sample()
+{
+#ifdef ABSTRACT_PROFILE
+    // This is called from within the interrupt, so don't count the inputs' I/O in the profile which loop() has open.
+    // (It would count operations which loop() didn't perform, and race with loop()'s own counting).
+    IOProfile* profile = abstractProfiler.current;
+    abstractProfiler.current = NULL;
+#endif
+
+    SamplerFrame frame = 0;
+    SamplerFrame mask = 1;
+    for ( byte i = 0; i < this->inputCount; i ++ ) {
+        if ( this->inputs[i]->get() ) {
+            frame |= mask;
+        }
+        mask <<= 1;
+    }
+
+#ifdef ABSTRACT_PROFILE
+    abstractProfiler.current = profile;
+#endif
+
+    this->latestFrame = frame;
+
+    byte h = this->head;
+    if ( (byte) (h - this->tail) >= ABSTRACT_SAMPLER_FRAMES ) {
+        this->overflows ++;
+        return;
+    }
+    this->frames[ h & ABSTRACT_SAMPLER_MASK ] = frame;
+    this->head = h + 1; // Only now is the frame visible to read().
+}
+
+SamplerFrame InputSampler::latest()
+{
+    // A frame may be more than one byte, so it can't be read atomically.
+    uint8_t oldSREG = SREG;
+    cli();
+    SamplerFrame frame = this->latestFrame;
+    SREG = oldSREG;
+    return frame;
+}
+
+boolean InputSampler::read( SamplerFrame* frame )
+{
+    // sample() never writes to the slot at tail while the buffer is full, so this is safe without disabling interrupts.
+    byte t = this->tail;
+    if ( t == this->head ) {
+        return false;
+    }
+    *frame = this->frames[ t & ABSTRACT_SAMPLER_MASK ];
+    this->tail = t + 1;
+    return true;
+}
+
+// SAMPLED INPUT
+
+SampledInput::SampledInput( InputSampler* sampler, byte bit )
+{
+    this->sampler = sampler;
+    this->mask = (SamplerFrame) 1 << bit;
+}
+
+boolean SampledInput::get()
+{
+    return (this->sampler->latest() & this->mask) != 0;
+}
+
+// END
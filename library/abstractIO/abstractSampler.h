@@ -0,0 +1,124 @@
+/*
+ * Samples a set of Inputs in the background, from a timer interrupt, at a fixed rate.
+ *
+ * Normally an Input is only read when your code calls get(), so the rate depends on how long your loop() takes.
+ * An InputSampler reads all of its inputs at a fixed rate (about 1kHz), and stores the results as a "frame"
+ * (one bit per input) in a ring buffer. SampledInput::get() then just reads a bit from the latest frame,
+ * and read() lets you process every frame in order, for deterministic debouncing and edge detection.
+ *
+ * The sampler uses Timer0's "compare A" interrupt, which fires once every 1.024ms. Timer0 is already running
+ * (it's used by millis()), so millis(), delay(), and analogWrite are unaffected, and Timer1 and Timer2 are still
+ * free for Servo, tone() etc.
+ *
+ * The inputs are read from within the interrupt, so only use inputs which are quick, and which do not use
+ * interrupts themselves. SimpleInput, FastInputAdapter and MuxInput (with an AddressSelector) are fine, but do NOT
+ * use MCP23017Input (Wire needs interrupts), or PortInput (it only returns the bank's value as of the last
+ * PortInputBank::read(), so it wouldn't be sampled at all).
+ *
+ * If you sample a MuxInput, then its Mux (and Selector) belong to the interrupt. Do NOT use them (or any other
+ * MuxInputs sharing them) from loop(), as the interrupt could change the selected address part way through.
+ *
+ * NOTE. This defines an interrupt handler, so it uses the .cpp.h bodge (see abstractPinChange.h).
+ * Include abstractSampler.cpp.h once in your sketch. Only supported on AVR based boards.
+ */
+
+#ifndef abstractSampler_h
+#define abstractSampler_h
+
+#include <Arduino.h>
+#include "abstractIO.h"
+
+// The maximum number of inputs. Use 8, 16 or 32.
+#ifndef ABSTRACT_SAMPLER_INPUTS
+#define ABSTRACT_SAMPLER_INPUTS 32
+#endif
+
+// The size of the ring buffer. Must be a power of 2, and no more than 128.
+#ifndef ABSTRACT_SAMPLER_FRAMES
+#define ABSTRACT_SAMPLER_FRAMES 8
+#endif
+
+#if ABSTRACT_SAMPLER_INPUTS <= 8
+typedef uint8_t SamplerFrame;
+#elif ABSTRACT_SAMPLER_INPUTS <= 16
+typedef uint16_t SamplerFrame;
+#else
+typedef uint32_t SamplerFrame;
+#endif
+
+class InputSampler;
+class SampledInput;
+
+class InputSampler
+{
+  public :
+    // The number of frames which were lost, because the ring buffer was full (read() wasn't called often enough).
+    volatile unsigned int overflows;
+
+  protected :
+    Input* inputs[ ABSTRACT_SAMPLER_INPUTS ];
+    byte inputCount;
+
+    byte divider; // Sample once every 'divider' timer ticks.
+    byte ticks;
+
+    // A single-producer (the interrupt), single-consumer (read) ring buffer.
+    // head and tail count the frames written and read. They are bytes, so they wrap around, and are read atomically.
+    // When the buffer is full, sample() drops the new frame, so frames which haven't been read are never overwritten.
+    volatile SamplerFrame frames[ ABSTRACT_SAMPLER_FRAMES ];
+    volatile byte head; // Only changed by sample()
+    volatile byte tail; // Only changed by read()
+
+    volatile SamplerFrame latestFrame; // Updated by every sample(), even when the ring buffer is full.
+
+  public :
+    InputSampler();
+
+    /*
+     * Starts sampling. The sample rate is 976.5625Hz divided by 'divider'.
+     * Add all of the inputs before calling begin().
+     */
+    void begin( byte divider = 1 );
+
+    /*
+     * Adds an Input to be sampled, returning an Input which reads the latest sample.
+     * If there are already ABSTRACT_SAMPLER_INPUTS inputs, then 'input' is returned unchanged.
+     */
+    Input* createInput( Input* input );
+
+    // Adds an Input, returning its bit number in the frames, or -1 if there is no room.
+    int add( Input* input );
+
+    // The most recent frame. Bit n is the value of the nth input added.
+    SamplerFrame latest();
+
+    /*
+     * Gets the oldest frame which hasn't been read yet. Returns false if there are no more frames.
+     * If read() isn't called often enough, then the newest frames are lost, and 'overflows' is incremented.
+     */
+    boolean read( SamplerFrame* frame );
+
+    /*
+     * Reads every input, and adds a new frame to the ring buffer. This is called by the timer interrupt.
+     */
+    void sample();
+
+    void tick(); // Called by the timer interrupt.
+};
+
+/*
+ * An Input which returns the latest sample taken by an InputSampler. Create these via InputSampler::createInput().
+ */
+class SampledInput : public Input
+{
+  protected :
+    InputSampler* sampler;
+    SamplerFrame mask;
+
+  public :
+    SampledInput( InputSampler* sampler, byte bit );
+
+    virtual boolean get();
+};
+
+#endif
@@ -15,11 +15,13 @@ ShiftRegister::ShiftRegister( byte dataPin, byte clockPin, boolean order )
 }
 
 void ShiftRegister::output( byte value ) {
+    IO_PROFILE( shiftedBytes, 1 );
     shiftOut( this->dataPin, this->clockPin, this->order, value );
     this->latchOutput();
 }
 
 void ShiftRegister::output( byte first, byte second ) {
+    IO_PROFILE( shiftedBytes, 2 );
     shiftOut( this->dataPin, this->clockPin, this->order, first );
     shiftOut( this->dataPin, this->clockPin, this->order, second );
     this->latchOutput();
@@ -27,8 +29,8 @@ void ShiftRegister::output( byte first, byte second ) {
 
 void ShiftRegister::output( byte byteCount, byte *values )
 {
+    IO_PROFILE( shiftedBytes, byteCount );
     for ( byte i = 0; i < byteCount; i ++ ) {
-        IO_DEBUG5("shiftOut", this->dataPin, this->clockPin, this->order, values[i] );
         shiftOut( this->dataPin, this->clockPin, this->order, values[i] );
     }
     this->latchOutput();
@@ -36,6 +38,7 @@ void ShiftRegister::output( byte byteCount, byte *values )
 
 void ShiftRegister::shift( boolean value, byte n )
 {
+    IO_PROFILE( digitalWrites, 2 + 2 * n );
     digitalWrite( dataPin, value );
     digitalWrite( clockPin, LOW );
     for (byte i = 0; i < n; i ++ ) {
@@ -49,8 +52,13 @@ void ShiftRegister::latchOutput()
     // Does nothing
 }
 
-BufferedShiftRegister* ShiftRegister::buffer( byte byteCount ) {
-    return new BufferedShiftRegister( this, byteCount );
+boolean ShiftRegister::isLatched()
+{
+    return false;
+}
+
+BufferedShiftRegister* ShiftRegister::buffer( byte byteCount, boolean doubleBuffered ) {
+    return ABSTRACT_NEW( BufferedShiftRegister )( this, byteCount, doubleBuffered );
 }
 
 // LATCHED SHIFT REGISTER
@@ -66,46 +74,83 @@ LatchedShiftRegister::LatchedShiftRegister( byte dataPin, byte clockPin, byte la
 
 void LatchedShiftRegister::latchOutput()
 {
+    IO_PROFILE( digitalWrites, 2 );
     digitalWrite( latchPin, HIGH );
     digitalWrite( latchPin, LOW );
 }
 
+boolean LatchedShiftRegister::isLatched()
+{
+    return true;
+}
+
 // BUFFERED SHIFT REGISTER
 
-BufferedShiftRegister::BufferedShiftRegister( ShiftRegister *shiftRegister, byte byteCount )
+BufferedShiftRegister::BufferedShiftRegister( ShiftRegister *shiftRegister, byte byteCount, boolean doubleBuffered )
 {
     this->shiftRegister = shiftRegister;
     this->byteCount = byteCount;
+    this->dirty = true; // The shift register's initial state is unknown, so the first update() must send everything.
     
-    this->buffer = (byte*) malloc( byteCount );
+    this->buffer = (byte*) ABSTRACT_MALLOC( byteCount, "BufferedShiftRegister buffer" );
     for ( int i = 0; i < byteCount; i ++ ) {
         this->buffer[i] = 0;
     }
+
+    this->latched = NULL;
+    if ( doubleBuffered ) {
+        this->latched = (byte*) ABSTRACT_MALLOC( byteCount, "BufferedShiftRegister buffer" );
+        for ( int i = 0; i < byteCount; i ++ ) {
+            this->latched[i] = 0xff; // Differs from the buffer, so that the first update() sends everything.
+        }
+    }
 }
 
 void BufferedShiftRegister::set( byte index, boolean value )
 {
-    byte *val = this->buffer + (index >> 4);
+    byte *val = this->buffer + (index >> 3);
     byte mask = 1 << (index %8);
+    byte old = *val;
     
     *val |= mask;
     if ( !value ) {
         *val ^= mask;
     }
+    if ( *val != old ) {
+        this->dirty = true;
+    }
 }
 
 void BufferedShiftRegister::update()
 {
-    this->shiftRegister->output( this->byteCount, this->buffer );
+    if ( this->latched ) {
+        // Compare against the data last sent, which also catches changes made directly to the buffer,
+        // and bits which were changed, and then changed back again.
+        boolean changed = false;
+        for ( byte i = 0; i < this->byteCount; i ++ ) {
+            if ( this->latched[i] != this->buffer[i] ) {
+                this->latched[i] = this->buffer[i];
+                changed = true;
+            }
+        }
+        this->dirty = false;
+        if ( changed ) {
+            this->shiftRegister->output( this->byteCount, this->latched );
+        }
+
+    } else if ( this->dirty ) {
+        this->dirty = false;
+        this->shiftRegister->output( this->byteCount, this->buffer );
+    }
 }
 
 
 BufferedOutput** BufferedShiftRegister::createOutputs()
 {
-    BufferedOutput** result = (BufferedOutput**) malloc( sizeof(BufferedOutput*) * this->byteCount * 8 );
+    BufferedOutput** result = (BufferedOutput**) ABSTRACT_MALLOC( sizeof(BufferedOutput*) * this->byteCount * 8, "BufferedOutput array" );
     for (int i = 0; i < this->byteCount; i ++ ) {
         for (int j = 0; j < 8; j ++ ) {
-            result[i * 8 + j] = new BufferedOutput( this->buffer + i, j );
+            result[i * 8 + j] = ABSTRACT_NEW( BufferedOutput )( this->buffer + i, j, &this->dirty );
         }
     }
     return result;
@@ -113,12 +158,17 @@ BufferedOutput** BufferedShiftRegister::createOutputs()
 
 // SHIFT REGISTER SELECTOR
 
-ShiftRegisterSelector::ShiftRegisterSelector( ShiftRegister *shiftRegister, byte addresses, boolean activeHighLow )
+ShiftRegisterSelector::ShiftRegisterSelector( ShiftRegister *shiftRegister, byte addresses, boolean activeHighLow, boolean wholeBytes )
 {
     this->shiftRegister = shiftRegister;
     this->addresses = addresses;
     this->activeHighLow = activeHighLow;
 
+    this->pattern = NULL;
+    if ( wholeBytes ) {
+        this->pattern = (byte*) ABSTRACT_MALLOC( (addresses + 7) / 8, "ShiftRegisterSelector pattern" );
+    }
+
     this->previousAddress = 1;
     select( 0 );
 }
@@ -128,8 +178,29 @@ void ShiftRegisterSelector::select( byte address )
     if ( address == this->previousAddress ) {
         return;
     }
-                
-    if ( address > this->previousAddress ) {
+
+    if ( this->pattern ) {
+        // Build the whole pattern, with a single active bit.
+        // The last bit shifted out ends up on Q0 of the first shift register, which is address 0.
+        byte byteCount = (this->addresses + 7) / 8;
+        byte inactive = this->activeHighLow ? 0 : 0xff;
+        for ( byte i = 0; i < byteCount; i ++ ) {
+            this->pattern[i] = inactive;
+        }
+        if ( ! this->shiftRegister->isLatched() ) {
+            // The outputs change as each bit is shifted, so move the previously active bit out of the way first.
+            // Otherwise, it and the new active bit would both be on the outputs at the same time.
+            this->shiftRegister->output( byteCount, this->pattern );
+        }
+        if ( address < this->addresses ) {
+            byte position = byteCount * 8 - 1 - address; // The order in which the active bit is shifted out.
+            byte bit = this->shiftRegister->order == LSBFIRST ? position % 8 : 7 - position % 8;
+            this->pattern[ position / 8 ] ^= 1 << bit;
+        }
+
+        this->shiftRegister->output( byteCount, this->pattern );
+
+    } else if ( address > this->previousAddress ) {
         // We are currently LESS than the required address, so just shift by the difference.
 
         this->shiftRegister->shift( ! this->activeHighLow, address - this->previousAddress );
@@ -171,4 +242,75 @@ void ComboSelector::select( byte address )
     this->shiftRegister->output( value );
 }
 
+// PARALLEL IN SHIFT REGISTER
+
+ParallelInShiftRegister::ParallelInShiftRegister( byte dataPin, byte clockPin, byte loadPin, byte byteCount, boolean order )
+{
+    this->dataPin = dataPin;
+    this->clockPin = clockPin;
+    this->loadPin = loadPin;
+    this->byteCount = byteCount;
+    this->order = order;
+
+    this->buffer = (byte*) ABSTRACT_MALLOC( byteCount, "ParallelInShiftRegister buffer" );
+    for ( int i = 0; i < byteCount; i ++ ) {
+        this->buffer[i] = 0;
+    }
+
+    digitalWrite( clockPin, LOW );
+    digitalWrite( loadPin, HIGH ); // The load pin is active LOW.
+    pinMode( clockPin, OUTPUT );
+    pinMode( loadPin, OUTPUT );
+    pinMode( dataPin, INPUT );
+}
+
+void ParallelInShiftRegister::read()
+{
+    // Copy the parallel inputs into the shift registers.
+    IO_PROFILE( digitalWrites, 2 );
+    digitalWrite( this->loadPin, LOW );
+    digitalWrite( this->loadPin, HIGH );
+
+    this->transfer();
+}
+
+void ParallelInShiftRegister::transfer()
+{
+    // Note, shiftIn() isn't used, because it reads the data AFTER the clock's rising edge, and the 74xx165's
+    // first bit is available as soon as the inputs are loaded (so shiftIn would lose the first bit).
+    IO_PROFILE( shiftedBytes, this->byteCount );
+    for ( byte i = 0; i < this->byteCount; i ++ ) {
+        byte value = 0;
+        for ( byte b = 0; b < 8; b ++ ) {
+            if ( digitalRead( this->dataPin ) ) {
+                value |= this->order == LSBFIRST ? (1 << b) : (0x80 >> b);
+            }
+            digitalWrite( this->clockPin, HIGH );
+            digitalWrite( this->clockPin, LOW );
+        }
+        this->buffer[i] = value;
+    }
+}
+
+boolean ParallelInShiftRegister::get( byte index )
+{
+    return (this->buffer[ index >> 3 ] & (1 << (index % 8))) != 0;
+}
+
+Input* ParallelInShiftRegister::createInput( byte index, boolean trueReading )
+{
+    return ABSTRACT_NEW( BufferedInput )( this->buffer, index, trueReading );
+}
+
+BufferedInput** ParallelInShiftRegister::createInputs( boolean trueReading )
+{
+    BufferedInput** result = (BufferedInput**) ABSTRACT_MALLOC( sizeof(BufferedInput*) * this->byteCount * 8, "BufferedInput array" );
+    for (int i = 0; i < this->byteCount; i ++ ) {
+        for (int j = 0; j < 8; j ++ ) {
+            result[i * 8 + j] = ABSTRACT_NEW( BufferedInput )( this->buffer + i, j, trueReading );
+        }
+    }
+    return result;
+}
+
 // END
@@ -9,13 +9,19 @@ class LatchedShiftRegister;
 class BufferedShiftRegister;
 class ShiftRegisterSelector;
 class ComboSelector;
+class ParallelInShiftRegister;
 
 /*
  * An unlatched shift register, such as a 74xx164.
  * Note, I prefer to use a LatchedShiftRegister, such as a 74xx595 in more scenarios.
+ *
+ * The data is "bit-banged" using shiftOut(). For long chains, see SPIShiftRegister (abstractSPIShiftRegister.h),
+ * which uses the Arduino's SPI hardware instead.
  */
 class ShiftRegister
 {
+  friend class ShiftRegisterSelector;
+
   protected :
     byte clockPin;
     byte dataPin;
@@ -27,26 +33,32 @@ class ShiftRegister
     /*
      * Shifts out a single byte.
      */
-    void output( byte value );
+    virtual void output( byte value );
 
     /*
      * Shifts out two bytes
      */
-    void output( byte first, byte second );
+    virtual void output( byte first, byte second );
     
     /*
      * Shifts out an array of bytes.
      */
-    void output( byte byteCount, byte *values );
+    virtual void output( byte byteCount, byte *values );
     
     virtual void latchOutput(); /* Does nothing. the LatchedShiftRegister overrides this */
+
+    /*
+     * Do the outputs only change when latchOutput() is called? false (the outputs change as each bit is shifted).
+     */
+    virtual boolean isLatched();
     
     /*
      * Shift in n bits of data, with the given value. Note, latchOutput() is not called.
      */
-    void shift ( boolean value, byte n = 1 );
+    virtual void shift ( boolean value, byte n = 1 );
 
-    BufferedShiftRegister* buffer( byte byteCount );
+    // See BufferedShiftRegister for details of doubleBuffered.
+    BufferedShiftRegister* buffer( byte byteCount, boolean doubleBuffered = false );
 };
 
 /*
@@ -61,11 +73,18 @@ class LatchedShiftRegister : public ShiftRegister
     LatchedShiftRegister( byte dataPin, byte clockPin, byte latchPin, boolean order=MSBFIRST /* or LSBFIRST*/ );
         
     virtual void latchOutput();
+    virtual boolean isLatched(); // true
 };
 
 /*
  * Keeps the state of the shift register in a buffer.
  * This is useful in conjunction with BufferedOutput.
+ *
+ * update() only sends the buffer to the shift register if it has changed since the previous update().
+ * Changes made via set() and the BufferedOutputs from createOutputs() are tracked automatically.
+ * If you change 'buffer' directly, then either set 'dirty' to true, or use doubleBuffered mode, which keeps
+ * a copy of the data last sent to the shift register, and compares the buffer against it (at the cost of
+ * byteCount extra bytes of RAM).
  */
 class BufferedShiftRegister
 {
@@ -75,8 +94,13 @@ class BufferedShiftRegister
   public :      
     byte byteCount;
     byte *buffer;
+    boolean dirty; // true when the buffer has changed since the last update(). Ignored when doubleBuffered.
 
-    BufferedShiftRegister( ShiftRegister *shiftRegister, byte byteCount );
+  protected :
+    byte *latched; // A copy of the data last sent to the shift register. NULL unless doubleBuffered.
+
+  public :
+    BufferedShiftRegister( ShiftRegister *shiftRegister, byte byteCount, boolean doubleBuffered = false );
     
     /*
      * Sets an individual bit of the buffer.
@@ -85,7 +109,7 @@ class BufferedShiftRegister
     void set( byte index, boolean value );
     
     /*
-     * Copies the value in the buffer into the shift register.
+     * Copies the value in the buffer into the shift register, if it has changed.
      */
     void update();
     
@@ -105,7 +129,16 @@ class BufferedShiftRegister
  * 
  * However, shift registers can be easily chained, so you can drive an unlimited number of chip-select lines using just 3 pins
  * (data, clock and latch).
- */ 
+ *
+ * By default, select() moves the active bit by shifting in single bits, which is quick when moving to the next address,
+ * but slow for long chains when moving backwards (up to 2 * addresses clock pulses, each using digitalWrite).
+ * If wholeBytes is true, select() instead builds the complete pattern, and sends it as whole bytes using
+ * ShiftRegister::output( byteCount, values ), so every select takes the same time, and is much quicker with an
+ * SPIShiftRegister (which has to bit-bang single bits).
+ * Either way, only one of the outputs is ever active at a time. However, with an unlatched shift register (such as
+ * a 74xx164), the active bit passes through the outputs before it, on its way to the selected output. For wholeBytes,
+ * this means that every select() first shifts out a pattern with no active bits, which doubles the time it takes.
+ */
 class ShiftRegisterSelector : public Selector
 {
   protected :
@@ -113,9 +146,10 @@ class ShiftRegisterSelector : public Selector
     byte addresses;
     boolean activeHighLow;
     byte previousAddress;
+    byte *pattern; // Only used when wholeBytes is true (otherwise NULL).
   
   public :
-    ShiftRegisterSelector( ShiftRegister *shiftRegister, byte addresses, boolean activeHighLow = LOW );
+    ShiftRegisterSelector( ShiftRegister *shiftRegister, byte addresses, boolean activeHighLow = LOW, boolean wholeBytes = false );
     virtual void select( byte address );
 };
 
@@ -150,4 +184,61 @@ class ComboSelector : public Selector
     virtual void select( byte address /* 0..39 */ );
 };
 
+/*
+ * A chain of parallel-in, serial-out shift registers, such as the 74xx165, used to add extra inputs.
+ * Each 74xx165 gives 8 inputs, using just 3 pins (data, clock and load), however many are chained together.
+ *
+ * read() loads all of the inputs at once, and then shifts them into a buffer. The Inputs created by createInput()
+ * and createInputs() then read a bit from the buffer, so call read() once per loop(), (in much the same way as
+ * BufferedShiftRegister::update()).
+ *
+ * Connect the 74xx165's serial output (Q7, pin 9) to dataPin, its clock (CP, pin 2) to clockPin, and its
+ * parallel load (PL, pin 1) to loadPin. Tie its clock enable (CE, pin 15) LOW.
+ * To chain them, connect Q7 of the furthest chip to the serial input (DS, pin 10) of the next chip.
+ *
+ * Input number 0..7 are from the 74xx165 connected to the Arduino, 8..15 are from the next one in the chain, etc.
+ * With MSBFIRST (the default), pin D7 of a chip is input 7, and D0 is input 0.
+ *
+ * For long chains, see SPIParallelInShiftRegister (in abstractSPIShiftRegister.h), which is much quicker.
+ */
+class ParallelInShiftRegister
+{
+  protected :
+    byte dataPin;
+    byte clockPin;
+    byte loadPin;
+    boolean order;
+
+  public :
+    byte byteCount;
+    byte *buffer;
+
+    ParallelInShiftRegister( byte dataPin, byte clockPin, byte loadPin, byte byteCount, boolean order=MSBFIRST /* or LSBFIRST*/ );
+
+    /*
+     * Loads the values of all of the inputs, and shifts them into the buffer.
+     */
+    void read();
+
+    /*
+     * Gets the value of an individual input from the buffer (as of the last read()).
+     */
+    boolean get( byte index );
+
+    /*
+     * Creates an Input for a single bit of the buffer.
+     * Use trueReading = LOW for buttons with pullup resistors, so that get() returns true when pressed.
+     */
+    Input* createInput( byte index, boolean trueReading = HIGH /* or LOW */ );
+
+    /*
+     * Create an array of Input objects. The size of the array is 8 * byteCount (passed to the constructor).
+     */
+    BufferedInput** createInputs( boolean trueReading = HIGH /* or LOW */ );
+
+  protected :
+    // Shifts byteCount bytes into the buffer. Called by read() after the inputs have been loaded.
+    virtual void transfer();
+};
+
 #endif